@@ -0,0 +1,57 @@
+#include "bench.hpp"
+#include "../tree/avltree.hpp"
+#include "../tree/rbtree.hpp"
+
+// AVL과 Red-Black 트리의 높이, 회전 수, 탐색 지연 비교
+
+template <typename TreeT>
+void run(const string& name, const vector<int>& keys, const vector<int>& probes) {
+    TreeT tree;
+
+    double insert_ms = measureMs([&] {
+        for (int k : keys) tree.insert(k);
+    });
+    long long insert_rotations = tree.getStats().rotations;
+    int height = tree.height();
+
+    tree.resetStats();
+    double search_ms = measureMs([&] {
+        for (int k : probes) tree.search(k);
+    });
+    double visited_per_lookup = double(tree.getStats().visited) / probes.size();
+
+    tree.resetStats();
+    double remove_ms = measureMs([&] {
+        for (size_t i = 0; i < keys.size(); i += 2) tree.remove(keys[i]);
+    });
+    long long remove_rotations = tree.getStats().rotations;
+
+    printRow(name, {
+        to_string(height),
+        to_string(insert_rotations),
+        to_string(remove_rotations),
+        fmt(insert_ms), fmt(search_ms * 1e6 / probes.size() / 1e3), fmt(visited_per_lookup), fmt(remove_ms)
+    });
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 100000;
+
+    vector<int> probes = shuffledKeys(n, 7);
+
+    struct Workload { string name; vector<int> keys; };
+    vector<Workload> workloads = {
+        {"sequential", sequentialKeys(n)},
+        {"random", shuffledKeys(n)},
+    };
+
+    for (const Workload& w : workloads) {
+        cout << "== " << w.name << " (n=" << n << ") ==\n";
+        printRow("tree", {"height", "ins rot", "del rot", "insert ms", "us/lookup", "visit/lookup", "remove ms"});
+        run<AVLTree<int>>("AVLTree", w.keys, probes);
+        run<RBTree<int>>("RBTree", w.keys, probes);
+        cout << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+#include "../tree/bplustree.hpp"
+
+// 큰 트리에서 무작위 조회를 많이 할 때 searchBatch(group개를 층마다 나란히 진행)의 처리량
+// search()는 시각화 호출을 포함한 기존 경로이고, group 1은 같은 batch 코드를 하나씩 돌린 것이라
+// 그 차이가 miss를 겹친 효과다. 조회 키 절반은 없는 키다.
+
+template <typename TreeT>
+void run(const string& name, TreeT& tree, const vector<int>& probes, const vector<bool>& expected) {
+    cout << "== " << name << " ==\n";
+    printRow("lookup", {"ns/probe", "speedup", "check"});
+
+    int found = 0;
+    double base_ms = measureMs([&] {
+        for (int k : probes) found += tree.search(k);
+    });
+    int expected_hits = count(expected.begin(), expected.end(), true);
+    printRow("search()", {fmt(base_ms * 1e6 / probes.size(), 0), "-", found == expected_hits ? "ok" : "MISMATCH"});
+
+    double single_ms = 0;
+    for (int group : {1, 4, 8, 16, 32, 64}) {
+        vector<bool> result;
+        double ms = measureMs([&] { result = tree.searchBatch(probes, group); });
+        if (group == 1) single_ms = ms;
+        printRow("searchBatch group=" + to_string(group),
+                 {fmt(ms * 1e6 / probes.size(), 0), fmt(single_ms / ms, 2) + "x", result == expected ? "ok" : "MISMATCH"});
+    }
+    cout << '\n';
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 4000000, t = 16, count = 1000000;
+    vector<int> keys = shuffledKeys(n);
+
+    mt19937 rng(11);
+    vector<int> probes(count);
+    vector<bool> expected(count);
+    for (int i = 0; i < count; i++) {
+        expected[i] = rng() % 2;
+        probes[i] = expected[i] ? rng() % n : n + rng() % n;
+    }
+
+    {
+        BPlusTree<int> tree(t);
+        for (int k : keys) tree.insert(k);
+        run("BPlusTree t=" + to_string(t) + ", n=" + to_string(n), tree, probes, expected);
+    }
+    {
+        BTree<int> tree(t);
+        for (int k : keys) tree.insert(k);
+        run("BTree t=" + to_string(t) + ", n=" + to_string(n), tree, probes, expected);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <cmath>
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// 벤치마크 공통 도구: 시간 측정과 워크로드 생성
+// 빌드: g++ -std=c++17 -O2 bench/<name>.cpp -o <name>
+
+template <typename F>
+double measureMs(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - start).count();
+}
+
+inline vector<int> sequentialKeys(int n) {
+    vector<int> keys(n);
+    iota(keys.begin(), keys.end(), 0);
+    return keys;
+}
+
+inline vector<int> shuffledKeys(int n, unsigned seed = 42) {
+    vector<int> keys = sequentialKeys(n);
+    shuffle(keys.begin(), keys.end(), mt19937{seed});
+    return keys;
+}
+
+inline void printRow(const string& name, const vector<string>& cols) {
+    cout << left << setw(28) << name;
+    for (const string& c : cols) cout << right << setw(14) << c;
+    cout << '\n';
+}
+
+inline string fmt(double v, int precision = 2) {
+    ostringstream ss;
+    ss << fixed << setprecision(precision) << v;
+    return ss.str();
+}
+
+// 순위 r(0부터)이 1/(r+1)^s 확률로 뽑히는 Zipf 분포. 순위 -> 키 매핑은 ranked_keys가 정한다.
+class ZipfGenerator {
+public:
+    ZipfGenerator(vector<int> ranked_keys, double s, unsigned seed = 1)
+        : keys(move(ranked_keys)), rng(seed), uniform(0.0, 1.0) {
+        cdf.resize(keys.size());
+        double sum = 0;
+        for (size_t r = 0; r < keys.size(); r++) {
+            sum += 1.0 / pow(double(r + 1), s);
+            cdf[r] = sum;
+        }
+        for (double& c : cdf) c /= sum;
+    }
+
+    int next() {
+        double u = uniform(rng);
+        size_t r = lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        return keys[min(r, keys.size() - 1)];
+    }
+
+private:
+    vector<int> keys;
+    vector<double> cdf;
+    mt19937 rng;
+    uniform_real_distribution<double> uniform;
+};
+
+// 하드웨어 캐시 miss 카운터 (Linux perf_event). 가상 머신처럼 카운터를 못 여는 곳에서는 available()이 false다.
+class CacheMissCounter {
+public:
+    enum Level { L1D, LLC };
+
+    explicit CacheMissCounter(Level level = L1D) {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = (level == L1D ? PERF_COUNT_HW_CACHE_L1D : PERF_COUNT_HW_CACHE_LL)
+                      | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    // f를 실행하는 동안의 miss 수. 카운터가 없으면 -1.
+    template <typename F>
+    long long count(F&& f) {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            f();
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long misses = 0;
+            if (read(fd, &misses, sizeof(misses)) == sizeof(misses)) return misses;
+            return -1;
+        }
+#endif
+        f();
+        return -1;
+    }
+
+private:
+    int fd = -1;
+};
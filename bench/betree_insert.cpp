@@ -0,0 +1,48 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+#include "../tree/betree.hpp"
+
+// 무작위 insert 처리량: 메시지를 버퍼에 모았다가 한꺼번에 내려보내는 Bε-트리와 BTree 비교
+// 같은 키를 넣은 뒤 있는 키/없는 키 search도 재서 버퍼를 훑는 조회 비용을 본다.
+
+template <typename TreeT>
+void run(const string& name, TreeT& tree, const vector<int>& keys, const vector<int>& probes, int expected) {
+    double insert_ms = measureMs([&] {
+        for (int k : keys) tree.insert(k);
+    });
+    int found = 0;
+    double search_ms = measureMs([&] {
+        for (int k : probes) found += tree.search(k);
+    });
+    printRow(name, {fmt(insert_ms), fmt(insert_ms * 1e6 / keys.size(), 0), fmt(keys.size() / insert_ms / 1e3, 2),
+                    fmt(search_ms * 1e6 / probes.size(), 0), found == expected ? "ok" : "MISMATCH"});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000, count = 500000;
+    vector<int> keys = shuffledKeys(n);
+
+    // 절반은 있는 키, 절반은 [n, 2n)의 없는 키
+    mt19937 rng(5);
+    vector<int> probes(count);
+    int expected = 0;
+    for (int& k : probes) {
+        bool hit = rng() % 2;
+        k = hit ? rng() % n : n + rng() % n;
+        expected += hit;
+    }
+
+    cout << "== n=" << n << " random inserts, " << count << " searches (50% hits) ==\n";
+    printRow("tree", {"insert ms", "ns/insert", "M inserts/s", "ns/search", "check"});
+    {
+        BTree<int> tree(16);
+        run("BTree t=16", tree, keys, probes, expected);
+    }
+    for (int buffer : {256, 1024, 4096}) {
+        BEpsilonTree<int> tree(16, buffer);
+        run("BEpsilon t=16 buf=" + to_string(buffer), tree, keys, probes, expected);
+        cout << "  flushes " << tree.getFlushCount() << ", still buffered " << tree.getBufferedCount() << "\n";
+    }
+    return 0;
+}
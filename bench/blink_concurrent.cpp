@@ -0,0 +1,171 @@
+#include <thread>
+#include <mutex>
+#include <set>
+#include <climits>
+#include "bench.hpp"
+#include "../tree/bplustree.hpp"
+#include "../tree/blink_tree.hpp"
+
+// BLinkTree 동시성 확인과 전역 락 대비 처리량
+// 1) stress: 쓰기 스레드는 자기 몫의 홀수 키를 무작위로 넣고 지우고, 읽기 스레드는 그동안
+//    미리 넣어 둔 짝수 키를 search/rangeScan으로 계속 확인한다. 짝수 키를 하나라도 못 찾거나
+//    rangeScan 순서가 어긋나거나, 끝난 뒤 내용이 각 쓰기 스레드가 기록한 집합과 다르면 MISMATCH.
+// 2) throughput: 짝수 키 n개를 넣어 두고 스레드마다 search(짝수 키)와 insert/remove(자기 몫의 홀수 키)를
+//    섞어 돌린다. BPlusTree와 BLinkTree를 mutex 하나로 감싼 것과 래치만 쓰는 BLinkTree를 비교한다.
+// 빌드: g++ -std=c++17 -O2 -pthread bench/blink_concurrent.cpp -o blink_concurrent
+
+// 쓰기 스레드 w의 i번째 키 (w마다 겹치지 않는 홀수)
+inline int oddKey(int w, int writers, int i) { return 2 * (i * writers + w) + 1; }
+
+bool stress(int t, int n, int writers, int readers, int ops) {
+    BLinkTree<int> tree(t);
+    vector<int> evens(n);
+    for (int i = 0; i < n; i++) evens[i] = 2 * i;
+    shuffle(evens.begin(), evens.end(), mt19937{7});
+
+    vector<set<int>> expected(writers);
+    vector<thread> threads;
+    atomic<int> writers_left{writers};
+    atomic<bool> failed{false};
+    // 짝수 키는 쓰기 스레드가 넣는 동안 절반씩 같이 넣는다 (초기 적재도 동시에 일어나게)
+    vector<int> preload(evens.begin(), evens.begin() + n / 2), concurrent(evens.begin() + n / 2, evens.end());
+    for (int k : preload) tree.insert(k);
+
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w] {
+            mt19937 rng(100 + w);
+            int span = max(1, ops / 4);
+            for (size_t i = w; i < concurrent.size(); i += writers) tree.insert(concurrent[i]);
+            for (int i = 0; i < ops; i++) {
+                int k = oddKey(w, writers, rng() % span);
+                if (rng() % 3) {
+                    if (tree.insert(k) != expected[w].insert(k).second) failed = true;
+                } else {
+                    if (tree.remove(k) != (expected[w].erase(k) > 0)) failed = true;
+                }
+            }
+            writers_left--;
+        });
+    }
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            mt19937 rng(200 + r);
+            while (writers_left > 0) {
+                int k = preload[rng() % preload.size()];  // 처음부터 들어 있던 짝수 키
+                if (!tree.search(k)) failed = true;
+                int prev = -1, evens_seen = 0;
+                tree.rangeScan(k, k + 64, [&](int x) {
+                    if (x <= prev) failed = true;
+                    prev = x;
+                    evens_seen += x % 2 == 0;
+                });
+                if (evens_seen == 0) failed = true;
+            }
+        });
+    }
+    for (thread& th : threads) th.join();
+
+    set<int> all(evens.begin(), evens.end());
+    for (const set<int>& s : expected) all.insert(s.begin(), s.end());
+    vector<int> scanned;
+    tree.rangeScan(INT_MIN, INT_MAX, [&](int x) { scanned.push_back(x); });
+    bool same = scanned.size() == all.size() && equal(scanned.begin(), scanned.end(), all.begin());
+    bool searchable = all_of(all.begin(), all.end(), [&](int k) { return tree.search(k); });
+    return !failed && same && searchable && tree.size() == all.size();
+}
+
+// 단일 트리를 mutex 하나로 감싼다
+template <typename TreeT>
+struct GlobalLock {
+    TreeT tree;
+    mutex m;
+    explicit GlobalLock(int t) : tree(t) {}
+    bool search(int k) {
+        lock_guard<mutex> g(m);
+        return tree.search(k);
+    }
+    bool insert(int k) {
+        lock_guard<mutex> g(m);
+        return tree.insert(k);
+    }
+    bool remove(int k) {
+        lock_guard<mutex> g(m);
+        return tree.remove(k);
+    }
+};
+
+// 스레드마다 ops번: write_pct%는 자기 홀수 키를 넣었다가 다음 번에 지우고, 나머지는 짝수 키 search
+template <typename TreeT>
+void throughput(const string& name, TreeT& tree, int n, int threads_n, int ops, int write_pct) {
+    atomic<long long> hits{0};
+    long long searches_total = 0;
+    vector<long long> searches(threads_n);
+    double ms = measureMs([&] {
+        vector<thread> threads;
+        for (int w = 0; w < threads_n; w++) {
+            threads.emplace_back([&, w] {
+                mt19937 rng(300 + w);
+                long long found = 0, count = 0;
+                int pending = -1, next = 0;
+                for (int i = 0; i < ops; i++) {
+                    if (int(rng() % 100) < write_pct) {
+                        if (pending < 0) {
+                            pending = oddKey(w, threads_n, next++);
+                            tree.insert(pending);
+                        } else {
+                            tree.remove(pending);
+                            pending = -1;
+                        }
+                    } else {
+                        found += tree.search(2 * int(rng() % n));
+                        count++;
+                    }
+                }
+                if (pending >= 0) tree.remove(pending);
+                hits += found;
+                searches[w] = count;
+            });
+        }
+        for (thread& th : threads) th.join();
+    });
+    for (long long c : searches) searches_total += c;
+    printRow(name, {to_string(threads_n), fmt(double(ops) * threads_n / ms / 1e3, 2),
+                    hits == searches_total ? "ok" : "MISMATCH"});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    cout << "hardware threads: " << thread::hardware_concurrency() << "\n";
+
+    cout << "== stress: writers insert/remove own odd keys, readers check preloaded even keys ==\n";
+    printRow("config", {"writers", "readers", "check"});
+    for (int t : {2, 3, 16}) {
+        bool ok = stress(t, 20000, 4, 4, 20000);
+        printRow("BLinkTree t=" + to_string(t), {"4", "4", ok ? "ok" : "MISMATCH"});
+    }
+
+    const int n = 1000000, ops = 200000;
+    vector<int> keys = shuffledKeys(n);
+    for (int write_pct : {10, 50}) {
+        cout << "== throughput: n=" << n << ", " << ops << " ops/thread, " << write_pct << "% writes ==\n";
+        printRow("tree", {"threads", "Mops/s", "check"});
+        for (int threads_n : {1, 2, 4, 8}) {
+            {
+                GlobalLock<BPlusTree<int>> tree(16);
+                for (int k : keys) tree.tree.insert(2 * k);
+                throughput("BPlusTree + mutex", tree, n, threads_n, ops, write_pct);
+            }
+            {
+                GlobalLock<BLinkTree<int>> tree(16);
+                for (int k : keys) tree.tree.insert(2 * k);
+                throughput("BLinkTree + mutex", tree, n, threads_n, ops, write_pct);
+            }
+            {
+                BLinkTree<int> tree(16);
+                for (int k : keys) tree.insert(2 * k);
+                throughput("BLinkTree (latches)", tree, n, threads_n, ops, write_pct);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+#include "../tree/bplustree.hpp"
+
+// 실패가 많은 조회(70%가 없는 키)에서 search 앞 Bloom 필터의 효과
+// hit rate: 필터만으로 끝난 조회 비율, FPR: 없는 키 중 필터를 통과한 비율
+
+template <typename TreeT>
+void run(const string& name, const vector<int>& keys, const vector<int>& probes, int expected) {
+    TreeT tree(16);
+    for (int k : keys) tree.insert(k);
+
+    for (double fpr : {0.0, 0.01, 0.001}) {
+        tree.setBloomFilter(fpr > 0, fpr);
+        int found = 0;
+        double ms = measureMs([&] {
+            for (int k : probes) found += tree.search(k);
+        });
+        BloomStats s = tree.getBloomStats();
+        string label = name + (fpr > 0 ? " fpr=" + fmt(fpr, 3) : " no filter");
+        printRow(label, {fmt(ms), fmt(ms * 1e6 / probes.size(), 0), fmt(s.hitRate() * 100, 1) + "%",
+                         fmt(s.falsePositiveRate() * 100, 2) + "%", fmt(s.bits / 8.0 / (1024 * 1024)),
+                         found == expected ? "ok" : "MISMATCH"});
+    }
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000, count = 1000000;
+    vector<int> keys = shuffledKeys(n);
+
+    // 30%는 있는 키, 70%는 [n, 2n)의 없는 키
+    mt19937 rng(7);
+    vector<int> probes(count);
+    int expected = 0;
+    for (int& k : probes) {
+        bool hit = rng() % 10 < 3;
+        k = hit ? rng() % n : n + rng() % n;
+        expected += hit;
+    }
+
+    cout << "== n=" << n << ", " << count << " searches, 70% misses ==\n";
+    printRow("tree", {"total ms", "ns/search", "hit rate", "FPR", "filter MB", "check"});
+    run<BTree<int>>("BTree t=16", keys, probes, expected);
+    run<BPlusTree<int>>("BPlusTree t=16", keys, probes, expected);
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include "bench.hpp"
+#include "../tree/bplustree.hpp"
+
+// 단조 증가 키(시간순 append)와 무작위 키의 BPlusTree 삽입 처리량 비교
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 200000;
+
+    vector<int> sequential = sequentialKeys(n);
+    vector<int> shuffled = shuffledKeys(n);
+
+    cout << "== BPlusTree insert (n=" << n << ") ==\n";
+    printRow("degree", {"append ms", "random ms", "ns/append"});
+    for (int t : {2, 4, 16, 64}) {
+        BPlusTree<int> append_tree(t);
+        double append_ms = measureMs([&] {
+            for (int k : sequential) append_tree.insert(k);
+        });
+        BPlusTree<int> random_tree(t);
+        double random_ms = measureMs([&] {
+            for (int k : shuffled) random_tree.insert(k);
+        });
+        printRow("t=" + to_string(t), {fmt(append_ms), fmt(random_ms), fmt(append_ms * 1e6 / n, 1)});
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "bench.hpp"
+#include "../tree/bplustree.hpp"
+
+// BPlusTree 리프 체인 / 하강 prefetch 효과
+// 무작위 순서로 넣어 리프가 힙에 흩어진 큰 트리에서 prefetch 거리별로
+//  - 전체 rangeScan 대역폭 (키 바이트 / 시간)
+//  - 폭 1000짜리 rangeScan 여러 번
+//  - 한 키짜리 rangeScan(k, k)로 잰 하강 (silent 경로)과 search (시각화 호출 포함 경로)
+// 을 잰다. 거리 0은 prefetch를 모두 끈 것이다. 각 측정은 두 번 돌려 빠른 쪽을 쓴다.
+
+template <typename F>
+double bestOf2(F f) {
+    return min(measureMs(f), measureMs(f));
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 4000000, t = 16, probes = 200000, ranges = 2000;
+    BPlusTree<int> tree(t);
+    for (int k : shuffledKeys(n)) tree.insert(k);
+
+    mt19937 rng(5);
+    vector<int> keys(probes), starts(ranges);
+    for (int& k : keys) k = rng() % n;
+    for (int& s : starts) s = rng() % (n - 1000);
+
+    cout << "== BPlusTree t=" << t << ", n=" << n << " (random insert order) ==\n";
+    printRow("prefetch distance", {"scan MB/s", "ns/key", "us/range", "ns/descent", "ns/search", "check"});
+    for (int distance : {0, 1, 2, 4, 8, 16}) {
+        tree.setPrefetchDistance(distance);
+
+        long long sum = 0;
+        double scan_ms = bestOf2([&] {
+            sum = 0;
+            tree.rangeScan(0, n - 1, [&](int k) { sum += k; });
+        });
+        long long range_sum = 0;
+        double range_ms = bestOf2([&] {
+            range_sum = 0;
+            for (int s : starts) tree.rangeScan(s, s + 999, [&](int k) { range_sum += k; });
+        });
+        int hits = 0;
+        double descent_ms = bestOf2([&] {
+            hits = 0;
+            for (int k : keys) hits += tree.rangeScan(k, k, [](int) {});
+        });
+        int found = 0;
+        double search_ms = bestOf2([&] {
+            found = 0;
+            for (int k : keys) found += tree.search(k);
+        });
+
+        long long expected_range = 0;
+        for (int s : starts) expected_range += 1000LL * s + 999LL * 1000 / 2;
+        bool ok = sum == (long long)n * (n - 1) / 2 && range_sum == expected_range && hits == probes && found == probes;
+        printRow(to_string(distance), {fmt(n * sizeof(int) / scan_ms / 1e3, 0), fmt(scan_ms * 1e6 / n, 2),
+                                       fmt(range_ms * 1e3 / ranges, 2), fmt(descent_ms * 1e6 / probes, 0),
+                                       fmt(search_ms * 1e6 / probes, 0), ok ? "ok" : "MISMATCH"});
+    }
+    return 0;
+}
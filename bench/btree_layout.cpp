@@ -0,0 +1,44 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+
+// BTree 노드의 hot/cold 블록 배치: 조회 한 번에 읽는 캐시 라인과 miss 수
+// lines: search 경로에서 읽는 서로 다른 64바이트 라인 (searchFootprint)
+// L1D/LLC miss: perf_event 하드웨어 카운터 (못 열면 n/a)
+
+string perLookup(long long misses, int count) {
+    return misses < 0 ? "n/a" : fmt(double(misses) / count);
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000, count = 200000;
+    vector<int> keys = shuffledKeys(n);
+    vector<int> probes = shuffledKeys(n, 7);
+    probes.resize(count);
+
+    CacheMissCounter l1(CacheMissCounter::L1D), llc(CacheMissCounter::LLC);
+    cout << "== n=" << n << ", " << count << " lookups, sizeof(BTreeNode<int>)=" << sizeof(BTreeNode<int>) << " ==\n";
+    printRow("tree", {"ns/lookup", "lines", "L1D miss", "LLC miss"});
+    for (int t : {2, 4, 8, 16, 32, 64}) {
+        BTree<int> tree(t);
+        for (int k : keys) tree.insert(k);
+
+        long long lines = 0;
+        for (int k : probes) lines += tree.searchFootprint(k);
+
+        int found = 0;
+        double ms = measureMs([&] {
+            for (int k : probes) found += tree.search(k);
+        });
+        long long l1_misses = l1.count([&] {
+            for (int k : probes) found += tree.search(k);
+        });
+        long long llc_misses = llc.count([&] {
+            for (int k : probes) found += tree.search(k);
+        });
+
+        printRow("BTree t=" + to_string(t), {fmt(ms * 1e6 / count, 0), fmt(double(lines) / count),
+                                             perLookup(l1_misses, count), perLookup(llc_misses, count)});
+    }
+    return 0;
+}
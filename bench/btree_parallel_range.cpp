@@ -0,0 +1,48 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+
+// BTree 범위 질의: 기존 rangeSearch(재귀 순회, 시각화 호출 포함)와
+// parallelRangeReduce(합계), parallelRangeCollect(키 순서 벡터)를 fork 깊이별로 비교한다.
+// 빌드: g++ -std=c++17 -O2 -pthread bench/btree_parallel_range.cpp
+// 병렬 이득은 코어 수에 따라 달라지므로 hardware_concurrency도 함께 출력한다.
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 2000000, t = 16;
+    vector<int> keys = shuffledKeys(n);
+    BTree<int> tree(t);
+    for (int k : keys) tree.insert(k);
+
+    cout << "hardware_concurrency=" << thread::hardware_concurrency()
+         << ", default fork depth=" << defaultForkDepth() << "\n\n";
+    vector<int> depths = {0, 1, 2, 4};
+    if (find(depths.begin(), depths.end(), defaultForkDepth()) == depths.end()) depths.push_back(defaultForkDepth());
+
+    for (double frac : {0.01, 0.5, 1.0}) {
+        int begin = int(n * (1 - frac) / 2), end = begin + int(n * frac) - 1;
+        long long expected = 0;
+        for (int k = begin; k <= end; k++) expected += k;
+
+        cout << "== BTree t=" << t << ", n=" << n << ", range " << end - begin + 1 << " keys ==\n";
+        printRow("query", {"ms", "check"});
+        double ms = measureMs([&] { tree.rangeSearch(begin, end); });
+        printRow("rangeSearch", {fmt(ms), "-"});
+
+        auto add = [](long long& s, int k) { s += k; };
+        auto sum = [](long long a, long long b) { return a + b; };
+        for (int depth : depths) {
+            long long total = 0;
+            ms = measureMs([&] { total = tree.parallelRangeReduce(begin, end, 0LL, add, sum, depth); });
+            printRow("reduce sum, depth " + to_string(depth), {fmt(ms), total == expected ? "ok" : "MISMATCH"});
+        }
+        for (int depth : {0, defaultForkDepth()}) {
+            vector<int> out;
+            ms = measureMs([&] { out = tree.parallelRangeCollect(begin, end, depth); });
+            bool ok = out.size() == size_t(end - begin + 1) && out.front() == begin &&
+                      is_sorted(out.begin(), out.end()) && out.back() == end;
+            printRow("collect, depth " + to_string(depth), {fmt(ms), ok ? "ok" : "MISMATCH"});
+        }
+        cout << '\n';
+    }
+    return 0;
+}
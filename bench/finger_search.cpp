@@ -0,0 +1,54 @@
+#include "bench.hpp"
+#include "../tree/rbtree.hpp"
+#include "../tree/bst.hpp"
+
+// 직전 탐색 위치 근처를 다시 찾는 워크로드에서 루트부터의 search와 fingerSearch 비교
+// step은 연속한 탐색 키 사이의 최대 거리다. 멀어질수록 finger의 이점이 줄어든다.
+// BST::search는 방문 수를 세지 않으므로 그 칸은 "-"로 출력한다.
+
+template <typename TreeT>
+void run(const string& name, const vector<int>& keys, const vector<int>& probes) {
+    TreeT tree;
+    for (int k : keys) tree.insert(k);
+
+    tree.resetStats();
+    double root_ms = measureMs([&] {
+        for (int k : probes) tree.search(k);
+    });
+    double root_visits = double(tree.getStats().visited) / probes.size();
+
+    typename TreeT::Finger finger;
+    tree.resetStats();
+    double finger_ms = measureMs([&] {
+        for (int k : probes) tree.fingerSearch(k, finger);
+    });
+    double finger_visits = double(tree.getStats().visited) / probes.size();
+
+    printRow(name + " search", {fmt(root_ms), root_visits > 0 ? fmt(root_visits) : "-"});
+    printRow(name + " fingerSearch", {fmt(finger_ms), fmt(finger_visits)});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 100000;
+    const int lookups = 200000;
+
+    vector<int> keys = shuffledKeys(n);
+    for (int step : {1, 16, 256, n}) {
+        mt19937 rng(7);
+        uniform_int_distribution<int> delta(-step, step);
+        vector<int> probes(lookups);
+        int cur = n / 2;
+        for (int& p : probes) {
+            cur = ((cur + delta(rng)) % n + n) % n;
+            p = cur;
+        }
+
+        cout << "== random walk step=" << step << " (n=" << n << ", lookups=" << lookups << ") ==\n";
+        printRow("tree", {"total ms", "visit/lookup"});
+        run<RBTree<int>>("RBTree", keys, probes);
+        run<BST<int>>("BST", keys, probes);
+        cout << '\n';
+    }
+    return 0;
+}
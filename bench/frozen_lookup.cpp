@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+#include "../tree/bplustree.hpp"
+#include "../tree/rbtree.hpp"
+#include "../tree/frozen_tree.hpp"
+
+// 읽기 전용 인덱스: 포인터 트리 조회와 freeze()한 배열 트리 조회 비교
+// 키는 짝수만 넣어 조회의 절반은 실패하고, lowerBound는 다음 짝수를 찾게 한다.
+
+template <typename F>
+void row(const string& name, const vector<int>& probes, long long expected, F lower_bound_of) {
+    long long sum = 0;
+    double ms = measureMs([&] {
+        for (int k : probes) sum += lower_bound_of(k);
+    });
+    printRow(name, {fmt(ms), fmt(ms * 1e6 / probes.size(), 0), sum == expected ? "ok" : "MISMATCH"});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000, count = 1000000;
+    vector<int> keys = shuffledKeys(n);
+    for (int& k : keys) k *= 2;
+    vector<int> probes = shuffledKeys(2 * n, 7);
+    probes.resize(count);
+
+    vector<int> sorted(keys);
+    sort(sorted.begin(), sorted.end());
+    long long expected = 0;
+    for (int k : probes) {
+        auto it = lower_bound(sorted.begin(), sorted.end(), k);
+        expected += it == sorted.end() ? -1 : *it;
+    }
+
+    BTree<int> bt(16);
+    BPlusTree<int> bp(16);
+    RBTree<int> rb;
+    for (int k : keys) {
+        bt.insert(k);
+        bp.insert(k);
+        rb.insert(k);
+    }
+
+    optional<FrozenTree<int>> eytzinger, blocked;
+    double freeze_ms = measureMs([&] { eytzinger.emplace(freeze<int>(rb)); });
+    blocked.emplace(freeze<int>(rb, FrozenTree<int>::BLOCKED));
+
+    cout << "== n=" << n << ", " << count << " lowerBound lookups ==\n";
+    cout << "freeze(RBTree): " << fmt(freeze_ms) << " ms, " << fmt(eytzinger->bytes() / (1024.0 * 1024.0))
+         << " MB (Eytzinger), " << fmt(blocked->bytes() / (1024.0 * 1024.0)) << " MB (blocked)\n";
+    printRow("index", {"total ms", "ns/lookup", "check"});
+    auto value = [](optional<int> k) { return k ? *k : -1; };
+    row("RBTree", probes, expected, [&](int k) { return value(rb.lowerBound(k)); });
+    row("BTree t=16", probes, expected, [&](int k) { return value(bt.lowerBound(k)); });
+    row("BPlusTree t=16", probes, expected, [&](int k) { return value(bp.lowerBound(k)); });
+    row("sorted vector", probes, expected, [&](int k) {
+        auto it = lower_bound(sorted.begin(), sorted.end(), k);
+        return it == sorted.end() ? -1 : *it;
+    });
+    row("Frozen Eytzinger", probes, expected, [&](int k) { return value(eytzinger->lowerBound(k)); });
+    row("Frozen blocked", probes, expected, [&](int k) { return value(blocked->lowerBound(k)); });
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <queue>
+#include "bench.hpp"
+#include "../tree/heap.hpp"
+#include "../tree/rbtree.hpp"
+
+// d-ary 힙, std::priority_queue, RBTree(최솟값부터 remove)의 우선순위 큐 처리량 비교
+
+template <int D>
+void runHeap(const vector<int>& keys) {
+    DaryHeap<int, D> heap;
+    double push_ms = measureMs([&] {
+        for (int k : keys) heap.push(k);
+    });
+    double pop_ms = measureMs([&] {
+        int out;
+        while (heap.pop(out)) {}
+    });
+    vector<typename DaryHeap<int, D>::Handle> handles;
+    double heapify_ms = measureMs([&] {
+        handles = heap.heapify(keys);
+    });
+    double decrease_ms = measureMs([&] {
+        for (size_t i = 0; i < keys.size(); i += 2)
+            heap.decreaseKey(handles[i], keys[i] - (int)keys.size());
+    });
+    printRow("DaryHeap<" + to_string(D) + ">", {fmt(push_ms), fmt(pop_ms), fmt(heapify_ms), fmt(decrease_ms)});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000;
+    vector<int> keys = shuffledKeys(n);
+
+    cout << "== priority queue (n=" << n << ") ==\n";
+    printRow("queue", {"push ms", "pop-all ms", "heapify ms", "decrease ms"});
+    runHeap<2>(keys);
+    runHeap<4>(keys);
+    runHeap<8>(keys);
+
+    priority_queue<int, vector<int>, greater<int>> pq;
+    double push_ms = measureMs([&] {
+        for (int k : keys) pq.push(k);
+    });
+    double pop_ms = measureMs([&] {
+        while (!pq.empty()) pq.pop();
+    });
+    double heapify_ms = measureMs([&] {
+        pq = priority_queue<int, vector<int>, greater<int>>(greater<int>{}, keys);
+    });
+    printRow("std::priority_queue", {fmt(push_ms), fmt(pop_ms), fmt(heapify_ms), "-"});
+
+    // RBTree에는 최솟값 API가 없으므로 오름차순 키를 알고 있다고 가정하고 앞에서부터 remove한다.
+    const int rb_n = n / 10;
+    vector<int> rb_keys(keys.begin(), keys.begin() + rb_n);
+    vector<int> drain_order = rb_keys;
+    sort(drain_order.begin(), drain_order.end());
+    RBTree<int> rb;
+    double rb_push_ms = measureMs([&] {
+        for (int k : rb_keys) rb.insert(k);
+    });
+    double rb_pop_ms = measureMs([&] {
+        for (int k : drain_order) rb.remove(k);
+    });
+    printRow("RBTree (n/10)", {fmt(rb_push_ms), fmt(rb_pop_ms), "-", "-"});
+
+    // 오래 쓰는 큐: 크기를 1000 근처로 유지하며 push/pop을 n번 반복해도 handle 표는 크기만큼만 자라야 하고,
+    // 슬롯이 재사용된 뒤에도 pop된 값의 handle은 거부되어야 한다.
+    {
+        DaryHeap<int, 4> heap;
+        mt19937 rng(9);
+        int out;
+        DaryHeap<int, 4>::Handle stale = heap.push(-1);
+        heap.pop(out);
+        for (int i = 0; i < 1000; i++) heap.push(rng());
+        double ms = measureMs([&] {
+            for (int i = 0; i < n; i++) {
+                heap.push(rng());
+                heap.pop(out);
+            }
+        });
+        cout << "\n== steady-state push+pop x" << n << " (size 1000) ==\n";
+        printRow("queue", {"ms", "handles", "check"});
+        printRow("DaryHeap<4>", {fmt(ms), to_string(heap.handleCapacity()), heap.handleCapacity() <= 1001 && !heap.contains(stale) && !heap.decreaseKey(stale, -2) ? "ok" : "MISMATCH"});
+    }
+
+    cout << "\n== sort (n=" << n << ") ==\n";
+    printRow("algorithm", {"ms"});
+    for (int d : {2, 4, 8}) {
+        vector<int> a = keys;
+        double ms = measureMs([&] {
+            if (d == 2) heapSort<2>(a);
+            else if (d == 4) heapSort<4>(a);
+            else heapSort<8>(a);
+        });
+        printRow("heapSort<" + to_string(d) + ">", {fmt(ms)});
+    }
+    vector<int> a = keys;
+    printRow("std::sort", {fmt(measureMs([&] { sort(a.begin(), a.end()); }))});
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "../tree/bplustree.hpp"
+#include "../tree/learned_bplustree.hpp"
+
+// 고르게 퍼진 정수 키에서 리프 디렉터리 위 선형 모델(LearnedBPlusTree)과 일반 B+ 하강 비교
+// 키의 80%를 넣은 뒤 나머지 20%를 더 넣어 incremental 재학습 비용과 그 뒤의 조회도 본다.
+
+template <typename TreeT>
+void run(const string& name, TreeT& tree, const vector<int>& keys, const vector<int>& probes) {
+    size_t base = keys.size() * 8 / 10;
+    double build_ms = measureMs([&] {
+        for (size_t i = 0; i < base; i++) tree.insert(keys[i]);
+    });
+    double more_ms = measureMs([&] {
+        for (size_t i = base; i < keys.size(); i++) tree.insert(keys[i]);
+    });
+
+    int found = 0;
+    double search_ms = measureMs([&] {
+        for (int k : probes) found += tree.search(k);
+    });
+    long long sum = 0;
+    double lower_ms = measureMs([&] {
+        for (int k : probes) sum += tree.lowerBound(k).value_or(-1);
+    });
+    printRow(name, {fmt(build_ms), fmt(more_ms * 1e6 / (keys.size() - base), 0), fmt(search_ms * 1e6 / probes.size(), 0),
+                    fmt(lower_ms * 1e6 / probes.size(), 0), to_string(found) + "/" + to_string(sum % 1000)});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000, count = 500000;
+
+    // [0, 100n) 안에서 고르게 뽑은 서로 다른 키
+    mt19937 rng(11);
+    vector<int> keys = shuffledKeys(n);
+    for (int& k : keys) k = k * 100 + rng() % 100;
+    vector<int> probes(count);
+    for (int& k : probes) k = rng() % (100 * n);
+
+    cout << "== n=" << n << " near-uniform keys, " << count << " probes ==\n";
+    printRow("tree", {"build ms", "ns/insert+", "ns/search", "ns/lowerBnd", "found/check"});
+    BPlusTree<int> plain(16);
+    run("BPlusTree t=16", plain, keys, probes);
+    for (int error : {4, 16}) {
+        LearnedBPlusTree<int> learned(16, error);
+        run("Learned t=16 err=" + to_string(error), learned, keys, probes);
+        cout << "  leaves " << learned.getLeafCount() << ", segments " << learned.getSegmentCount() << ", retrains "
+             << learned.getRetrainCount() << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "bench.hpp"
+#include "../tree/rbtree.hpp"
+#include "../tree/bplustree.hpp"
+#include "../tree/lsm_tree.hpp"
+
+// 무작위 insert를 계속 받을 때 LSM(RBTree memtable + BPlusTree run)과 단일 트리 비교
+// insert는 앞/뒤 절반으로 나눠 재서 트리가 커질 때 쓰기 비용이 얼마나 유지되는지 본다.
+// 그 뒤 search(절반은 없는 키)와 폭 1000짜리 rangeScan도 잰다.
+
+template <typename TreeT>
+void run(const string& name, TreeT& tree, const vector<int>& keys, const vector<int>& probes, int expected,
+         const vector<int>& starts) {
+    size_t half = keys.size() / 2;
+    double first_ms = measureMs([&] {
+        for (size_t i = 0; i < half; i++) tree.insert(keys[i]);
+    });
+    double second_ms = measureMs([&] {
+        for (size_t i = half; i < keys.size(); i++) tree.insert(keys[i]);
+    });
+    int found = 0;
+    double search_ms = measureMs([&] {
+        for (int k : probes) found += tree.search(k);
+    });
+    long long sum = 0;
+    double range_ms = measureMs([&] {
+        for (int s : starts) tree.rangeScan(s, s + 999, [&](int k) { sum += k; });
+    });
+    printRow(name, {fmt(first_ms * 1e6 / half, 0), fmt(second_ms * 1e6 / (keys.size() - half), 0),
+                    fmt(search_ms * 1e6 / probes.size(), 0), fmt(range_ms * 1e3 / starts.size(), 1),
+                    found == expected ? "ok" : "MISMATCH"});
+}
+
+// 단일 트리에는 rangeScan이 없으므로 successor로 같은 일을 하게 감싼다.
+template <typename TreeT>
+struct Scannable : TreeT {
+    using TreeT::TreeT;
+    template <typename F>
+    void rangeScan(int begin, int end, F f) {
+        for (optional<int> k = this->lowerBound(begin); k && *k <= end; k = this->successor(*k)) f(*k);
+    }
+};
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000, count = 200000, ranges = 200;
+    vector<int> keys = shuffledKeys(n);
+
+    mt19937 rng(3);
+    vector<int> probes(count);
+    int expected = 0;
+    for (int& k : probes) {
+        bool hit = rng() % 2;
+        k = hit ? rng() % n : n + rng() % n;
+        expected += hit;
+    }
+    vector<int> starts(ranges);
+    for (int& s : starts) s = rng() % n;
+
+    cout << "== n=" << n << " random inserts, " << count << " searches (50% hits), " << ranges << " scans of 1000 ==\n";
+    printRow("tree", {"ns/ins 1st", "ns/ins 2nd", "ns/search", "us/scan", "check"});
+    {
+        Scannable<RBTree<int>> tree;
+        run("RBTree", tree, keys, probes, expected, starts);
+    }
+    {
+        Scannable<BPlusTree<int>> tree(16);
+        run("BPlusTree t=16", tree, keys, probes, expected, starts);
+    }
+    for (int limit : {1024, 8192}) {
+        LSMTree<int> tree(limit, 4, 16);
+        run("LSM memtable=" + to_string(limit), tree, keys, probes, expected, starts);
+        tree.waitForCompaction();
+        cout << "  runs " << tree.getRunCount() << ", compactions " << tree.getCompactionCount() << "\n";
+    }
+    return 0;
+}
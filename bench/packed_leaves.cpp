@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include <cstdint>
+#include "../tree/bplustree.hpp"
+#include "../tree/packed_bplustree.hpp"
+
+// 촘촘한 ID 인덱스: BPlusTree<int64_t>와 bit-packing 리프(PackedBPlusTree) 비교
+// 키당 리프 바이트, 점 조회, 범위 스캔(키 1000개씩) 시간
+
+vector<int64_t> idKeys(int n, int max_gap, unsigned seed) {
+    mt19937 rng(seed);
+    vector<int64_t> keys(n);
+    int64_t id = 1000000000000LL;
+    for (int64_t& k : keys) k = id += 1 + rng() % max_gap;
+    return keys;
+}
+
+void run(const string& name, const vector<int64_t>& keys) {
+    vector<int64_t> order = keys;
+    shuffle(order.begin(), order.end(), mt19937{3});
+    vector<int64_t> probes(order.begin(), order.begin() + min<size_t>(order.size(), 200000));
+    const int scans = 2000;
+
+    BPlusTree<int64_t> plain(64);
+    PackedBPlusTree<int64_t> packed(256);
+    double plain_insert = measureMs([&] {
+        for (int64_t k : order) plain.insert(k);
+    });
+    double packed_insert = measureMs([&] {
+        for (int64_t k : order) packed.insert(k);
+    });
+
+    int found = 0;
+    double plain_search = measureMs([&] {
+        for (int64_t k : probes) found += plain.search(k);
+    });
+    double packed_search = measureMs([&] {
+        for (int64_t k : probes) found -= packed.search(k);
+    });
+
+    int64_t sum = 0;
+    double packed_scan = measureMs([&] {
+        for (int i = 0; i < scans; i++) {
+            size_t at = (i * 7919u) % (keys.size() - 1000);
+            packed.rangeScan(keys[at], keys[at + 999], [&](int64_t k) { sum += k; });
+        }
+    });
+    double plain_scan = measureMs([&] {
+        for (int i = 0; i < scans; i++) {
+            size_t at = (i * 7919u) % (keys.size() - 1000);
+            plain.rangeSearch(keys[at], keys[at + 999]);
+        }
+    });
+
+    double bytes_per_key = double(packed.leafBytes()) / packed.size();
+    cout << "== " << name << " (n=" << keys.size() << ") ==\n";
+    printRow("tree", {"leaf B/key", "insert ms", "search ms", "scan ms", "check"});
+    printRow("BPlusTree<int64_t> t=64", {fmt(sizeof(int64_t)), fmt(plain_insert), fmt(plain_search), fmt(plain_scan), "-"});
+    printRow("PackedBPlusTree cap=256", {fmt(bytes_per_key), fmt(packed_insert), fmt(packed_search), fmt(packed_scan),
+                                         found == 0 && sum != 0 ? "ok" : "MISMATCH"});
+    cout << '\n';
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000;
+    run("dense IDs, gap 1-4", idKeys(n, 4, 1));
+    run("IDs, gap 1-1000", idKeys(n, 1000, 2));
+    run("IDs, gap 1-2^30", idKeys(n, 1 << 30, 3));
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include <cstdio>
+#include "../tree/paged_bplustree.hpp"
+
+// 버퍼 풀보다 큰 작업 집합: 풀 크기(frame 수)를 바꿔 가며 조회 비용과 hit율 측정
+// 파일은 한 번 만들고 풀 크기마다 다시 연다 (OS 페이지 캐시는 비우지 않으므로 miss 비용은 pread 시스템 콜 비용에 가깝다).
+
+const string path = "/tmp/paged_bplustree_bench.db";
+
+string hitRate(const BufferPool::Stats& s) {
+    return fmt(100.0 * s.hits / max<uint64_t>(1, s.hits + s.misses), 1) + "%";
+}
+
+template <typename Next>
+void lookups(const string& name, uint32_t page_size, size_t frames, int count, Next next) {
+    PagedBPlusTree<int> tree(path, page_size, frames);
+    int hits = 0;
+    double ms = measureMs([&] {
+        for (int i = 0; i < count; i++) hits += tree.search(next());
+    });
+    BufferPool::Stats s = tree.getPoolStats();
+    printRow(name, {fmt(frames * page_size / 1024.0 / 1024.0, 1), fmt(ms), hitRate(s), to_string(s.misses),
+                    to_string(s.evictions), to_string(hits)});
+}
+
+void run(uint32_t page_size, const vector<int>& keys) {
+    double build_ms, file_mb;
+    BufferPool::Stats build;
+    {
+        PagedBPlusTree<int> tree(path, page_size, 64, true);
+        build_ms = measureMs([&] {
+            for (int k : keys) tree.insert(k);
+            tree.flush();
+        });
+        build = tree.getPoolStats();
+    }
+    FILE* f = fopen(path.c_str(), "rb");
+    fseek(f, 0, SEEK_END);
+    file_mb = ftell(f) / 1024.0 / 1024.0;
+    fclose(f);
+
+    cout << "== page " << page_size / 1024 << " KiB, n=" << keys.size() << ", file " << fmt(file_mb, 1) << " MB ==\n";
+    cout << "build with 64 frames: " << fmt(build_ms) << " ms, " << build.misses << " reads, " << build.writes
+         << " writes\n";
+    printRow("workload", {"pool MB", "ms", "hit rate", "reads", "evictions", "found"});
+
+    const int count = 200000;
+    for (size_t frames : {16, 64, 256, 1024, 4096}) {
+        mt19937 rng(1);
+        uniform_int_distribution<int> any(0, keys.size() - 1);
+        lookups("uniform frames=" + to_string(frames), page_size, frames, count, [&] { return any(rng); });
+    }
+    vector<int> ranked = shuffledKeys(keys.size(), 9);
+    ZipfGenerator zipf(ranked, 0.99);
+    for (size_t frames : {16, 256}) {
+        lookups("zipf 0.99 frames=" + to_string(frames), page_size, frames, count, [&] { return zipf.next(); });
+    }
+    cout << '\n';
+}
+
+int main() {
+    vector<int> keys = shuffledKeys(1000000);
+    run(4096, keys);
+    run(16384, keys);
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "bench.hpp"
+#include "../tree/rbtree.hpp"
+
+// 두 RBTree를 합치는 비용: 키를 하나씩 insert하는 방식과 join 기반 집합 연산 비교
+// 집합 연산은 인자로 받은 트리를 비우므로 매번 새로 만든다 (트리 생성 시간은 제외).
+// 빌드: g++ -std=c++17 -O2 -pthread bench/rb_set_ops.cpp
+// 병렬 이득은 코어 수에 따라 달라지므로 hardware_concurrency도 함께 출력한다.
+
+void build(RBTree<int>& tree, const vector<int>& keys) {
+    for (int k : keys) tree.insert(k);
+}
+
+template <typename Op>
+void run(const string& name, const vector<int>& a, const vector<int>& b, int depth, Op op) {
+    RBTree<int> left, right;
+    build(left, a);
+    build(right, b);
+    left.setParallelDepth(depth);
+
+    double ms = measureMs([&] { op(left, right); });
+    printRow(name, {fmt(ms), to_string(left.height())});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 200000;
+
+    cout << "hardware_concurrency=" << thread::hardware_concurrency()
+         << ", default fork depth=" << defaultForkDepth() << "\n\n";
+
+    // 겹침 비율이 다른 두 키 집합: 짝수/홀수 섞임(겹침 없음), 절반 겹침, 작은 트리 + 큰 트리
+    vector<int> keys = shuffledKeys(2 * n);
+    struct Workload { string name; vector<int> a, b; };
+    vector<Workload> workloads;
+    workloads.push_back({"disjoint interleaved", {}, {}});
+    for (int k : keys) (k % 2 ? workloads.back().a : workloads.back().b).push_back(k);
+    workloads.push_back({"half overlap", vector<int>(keys.begin(), keys.begin() + n),
+                         vector<int>(keys.begin() + n / 2, keys.begin() + n + n / 2)});
+    workloads.push_back({"large + small (1%)", vector<int>(keys.begin(), keys.begin() + n),
+                         vector<int>(keys.begin() + n, keys.begin() + n + n / 100)});
+
+    int depth = defaultForkDepth();
+    for (const Workload& w : workloads) {
+        cout << "== " << w.name << " (|A|=" << w.a.size() << ", |B|=" << w.b.size() << ") ==\n";
+        printRow("operation", {"ms", "height"});
+        run("insert each of B", w.a, w.b, 0, [&](RBTree<int>& l, RBTree<int>&) {
+            for (int k : w.b) l.insert(k);
+        });
+        run("unionWith (1 thread)", w.a, w.b, 0, [](RBTree<int>& l, RBTree<int>& r) { l.unionWith(r); });
+        run("unionWith (fork-join)", w.a, w.b, depth, [](RBTree<int>& l, RBTree<int>& r) { l.unionWith(r); });
+        run("intersectWith (fork-join)", w.a, w.b, depth, [](RBTree<int>& l, RBTree<int>& r) { l.intersectWith(r); });
+        run("differenceWith (fork-join)", w.a, w.b, depth, [](RBTree<int>& l, RBTree<int>& r) { l.differenceWith(r); });
+        cout << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include "bench.hpp"
+#include "../tree/bplustree.hpp"
+
+// 보존 기간이 지난 구간 삭제: 키마다 remove하는 것과 removeRange 한 번 비교
+// 시간 순서로 들어온 키(오래된 쪽 구간)와 무작위로 들어온 키(가운데 구간) 두 경우를 본다.
+// remove ms는 키마다 remove (lazy면 마지막 compact까지), range ms는 removeRange 한 번이다.
+
+void run(const string& name, const vector<int>& keys, int begin, int end, bool lazy) {
+    BPlusTree<int> naive(16), bulk(16);
+    naive.setLazyDelete(lazy);
+    bulk.setLazyDelete(lazy);
+    for (int k : keys) {
+        naive.insert(k);
+        bulk.insert(k);
+    }
+
+    int naive_removed = 0;
+    double naive_ms = measureMs([&] {
+        for (int k = begin; k <= end; k++) naive_removed += naive.remove(k);
+        if (lazy) naive.compact();
+    });
+    int bulk_removed = 0;
+    double bulk_ms = measureMs([&] { bulk_removed = bulk.removeRange(begin, end); });
+
+    bool same = naive_removed == bulk_removed && naive.search(end + 1) == bulk.search(end + 1) &&
+                naive.lowerBound(begin) == bulk.lowerBound(begin) && naive.predecessor(begin) == bulk.predecessor(begin);
+    printRow(name + (lazy ? " (lazy)" : ""),
+             {to_string(bulk_removed), fmt(naive_ms), fmt(bulk_ms, 3), same ? "ok" : "MISMATCH"});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 1000000;
+
+    cout << "== BPlusTree t=16, n=" << n << " ==\n";
+    printRow("window", {"removed", "remove ms", "range ms", "check"});
+    for (bool lazy : {false, true}) {
+        run("oldest 30%, seq", sequentialKeys(n), 0, n * 3 / 10 - 1, lazy);
+        run("middle 30%, shuffled", shuffledKeys(n), n * 4 / 10, n * 7 / 10 - 1, lazy);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <cstddef>
+#include "../tree/btree.hpp"
+#include "../tree/bplustree.hpp"
+#include "../tree/rbtree.hpp"
+
+// 재시작 비용: 키를 다시 insert해 트리를 만드는 시간과
+// 스냅샷을 mmap으로 열어 바로 조회하는 시간 비교
+
+template <typename TreeT>
+void run(const string& name, TreeT& tree, const vector<int>& keys, const vector<int>& probes) {
+    const string path = "/tmp/tree_snapshot_bench.bin";
+
+    double rebuild_ms = measureMs([&] {
+        for (int k : keys) tree.insert(k);
+    });
+    double save_ms = measureMs([&] { tree.saveSnapshot(path); });
+
+    SnapshotView<int> view;
+    double open_ms = measureMs([&] { view.open(path); });
+    int hits = 0;
+    double probe_ms = measureMs([&] {
+        for (int k : probes) hits += view.search(k);
+    });
+    double tree_ms = measureMs([&] {
+        for (int k : probes) hits -= tree.search(k);
+    });
+
+    FILE* f = fopen(path.c_str(), "rb");
+    fseek(f, 0, SEEK_END);
+    double mb = ftell(f) / (1024.0 * 1024.0);
+    fclose(f);
+    view.close();
+    remove(path.c_str());
+
+    printRow(name, {fmt(rebuild_ms), fmt(save_ms), fmt(open_ms * 1e3), fmt(probe_ms), fmt(tree_ms), fmt(mb),
+                    hits == 0 ? "ok" : "MISMATCH"});
+}
+
+// 깨진 스냅샷: 헤더의 차수를 키우거나 (레코드보다 큰 노드), node_count를 곱하면 넘치는 값으로 바꾸면
+// open이 거부해야 하고, 루트 레코드의 key_count를 터무니없이 키워도 조회가 레코드 밖을 읽지 않아야 한다.
+bool corruptCheck() {
+    const string path = "/tmp/tree_snapshot_corrupt.bin";
+    BTree<int> tree(3);
+    for (int k = 0; k < 100; k++) tree.insert(k);
+    tree.saveSnapshot(path);
+
+    auto patch = [&](long at, const void* value, size_t size) {
+        FILE* f = fopen(path.c_str(), "r+b");
+        fseek(f, at, SEEK_SET);
+        fwrite(value, size, 1, f);
+        fclose(f);
+    };
+    SnapshotHeader header;
+    FILE* f = fopen(path.c_str(), "rb");
+    fread(&header, sizeof(header), 1, f);
+    fclose(f);
+
+    SnapshotView<int> view;
+    bool ok = view.open(path) && view.search(42);
+    uint32_t big_degree = 1000;
+    patch(offsetof(SnapshotHeader, degree), &big_degree, 4);
+    ok = ok && !view.open(path);
+    patch(offsetof(SnapshotHeader, degree), &header.degree, 4);
+    uint64_t wrap = header.node_count + (1ULL << 61);  // record_size가 8의 배수라 곱하면 2^64의 배수만큼 넘친다
+    patch(offsetof(SnapshotHeader, node_count), &wrap, 8);
+    ok = ok && !view.open(path);
+    patch(offsetof(SnapshotHeader, node_count), &header.node_count, 8);
+    uint32_t huge_count = 0x7fffffff;
+    patch(header.root, &huge_count, 4);
+    ok = ok && view.open(path);
+    view.search(42);
+    int seen = 0;
+    view.forEach([&](int) { seen++; });
+    view.close();
+    remove(path.c_str());
+    return ok && seen > 0;
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 500000;
+    vector<int> keys = shuffledKeys(n);
+    vector<int> probes = shuffledKeys(2 * n, 7);
+    probes.resize(100000);
+
+    cout << "== n=" << n << ", " << probes.size() << " lookups ==\n";
+    printRow("tree", {"rebuild ms", "save ms", "mmap open us", "view ms", "tree ms", "file MB", "check"});
+    BTree<int> bt(16);
+    run("BTree t=16", bt, keys, probes);
+    BPlusTree<int> bp(16);
+    run("BPlusTree t=16", bp, keys, probes);
+    RBTree<int> rb;
+    run("RBTree", rb, keys, probes);
+
+    cout << "\n== corrupt snapshot ==\n";
+    printRow("BTree t=3", {corruptCheck() ? "ok" : "MISMATCH"});
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include "bench.hpp"
+#include "../tree/splaytree.hpp"
+#include "../tree/rbtree.hpp"
+
+// 소수의 hot key에 탐색이 몰리는 Zipf 워크로드에서 SplayTree와 RBTree 비교
+// RBTree::search는 방문하는 노드마다 시각화 메시지를 만들므로 시간에는 그 비용이 섞여 있다.
+// 알고리즘 자체의 차이는 visit/lookup으로 본다.
+
+template <typename TreeT>
+void run(const string& name, const vector<int>& keys, const vector<int>& probes) {
+    TreeT tree;
+    for (int k : keys) tree.insert(k);
+
+    tree.resetStats();
+    double ms = measureMs([&] {
+        for (int k : probes) tree.search(k);
+    });
+    printRow(name, {fmt(ms), fmt(ms * 1e3 / probes.size(), 3), fmt(double(tree.getStats().visited) / probes.size())});
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 100000;
+    const int lookups = 200000;
+
+    vector<int> keys = shuffledKeys(n);
+    for (double s : {0.0, 0.8, 0.99, 1.2}) {
+        // hot key가 키 공간에 흩어지도록 순위를 무작위 키에 매핑
+        ZipfGenerator zipf(shuffledKeys(n, 99), s);
+        vector<int> probes(lookups);
+        for (int& p : probes) p = zipf.next();
+
+        cout << "== zipf s=" << s << " (n=" << n << ", lookups=" << lookups << ") ==\n";
+        printRow("tree", {"total ms", "us/lookup", "visit/lookup"});
+        run<SplayTree<int>>("SplayTree", keys, probes);
+        run<RBTree<int>>("RBTree", keys, probes);
+        cout << '\n';
+    }
+    return 0;
+}
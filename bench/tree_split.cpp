@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "../tree/btree.hpp"
+#include "../tree/bplustree.hpp"
+
+// 샤드 재분배: 키 중간에서 인덱스를 자르는 비용
+// 기존 방식(절반을 remove해서 다른 트리에 insert)과 split/concat 비교
+
+template <typename TreeT>
+void run(const string& name, int t, const vector<int>& keys, int cut) {
+    TreeT naive_src(t), naive_dst(t);
+    for (int k : keys) naive_src.insert(k);
+    double naive_ms = measureMs([&] {
+        for (int k : keys)
+            if (k >= cut) {
+                naive_src.remove(k);
+                naive_dst.insert(k);
+            }
+    });
+
+    TreeT tree(t), left(t), right(t);
+    for (int k : keys) tree.insert(k);
+    double split_ms = measureMs([&] { tree.split(cut, left, right); });
+    double concat_ms = measureMs([&] { left.concat(right); });
+
+    printRow(name, {fmt(naive_ms), fmt(split_ms * 1e3), fmt(concat_ms * 1e3)});
+}
+
+// lazy delete로 지운 키가 있는 채로 split한 뒤 lazy delete를 끄면 남은 tombstone이 정리되어야 한다.
+// split 직후에는 키 수를 모르는 상태(stale)이므로 세어 보지 않고 건너뛰면 지운 키가 다시 지워진다.
+bool lazySplitCheck() {
+    BPlusTree<int> tree(3), left(3), right(3);
+    tree.setLazyDelete(true);
+    for (int k = 0; k < 100; k++) tree.insert(k);
+    for (int k = 0; k < 10; k++) tree.remove(k);
+    tree.split(50, left, right);
+    left.setLazyDelete(false);
+    return !left.remove(3) && left.getTombstoneCount() == 0 && left.search(10) && !left.search(9);
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    const int n = 200000;
+    vector<int> keys = shuffledKeys(n);
+
+    cout << "== cut at n/2 (n=" << n << ") ==\n";
+    printRow("tree", {"remove+insert ms", "split us", "concat us"});
+    for (int t : {4, 16, 64}) {
+        run<BTree<int>>("BTree t=" + to_string(t), t, keys, n / 2);
+        run<BPlusTree<int>>("BPlusTree t=" + to_string(t), t, keys, n / 2);
+    }
+
+    cout << "\n== lazy delete + split, then disable lazy delete ==\n";
+    printRow("BPlusTree t=3", {lazySplitCheck() ? "ok" : "MISMATCH"});
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "bench.hpp"
+#include <csignal>
+#include <set>
+#include <sys/wait.h>
+#include "../tree/bplustree.hpp"
+#include "../tree/durable_tree.hpp"
+
+// 1) group commit 크기에 따른 insert 처리량
+// 2) 스냅샷 + 로그 길이에 따른 재시작(복구) 시간
+// 3) 장애 주입: 로그를 쓴 직후 트리를 고치기 전에 SIGKILL로 죽인 뒤 복구 결과 확인
+// 빌드: g++ -std=c++17 -O2 bench/wal_recovery.cpp
+
+using Durable = DurableTree<BPlusTree<int>, int>;
+const string prefix = "/tmp/wal_recovery_bench";
+
+void clean() {
+    remove((prefix + ".snap").c_str());
+    remove((prefix + ".wal").c_str());
+}
+
+void groupCommit() {
+    const int n = 20000;
+    cout << "== group commit (" << n << " inserts) ==\n";
+    printRow("group size", {"ms", "fdatasync", "ops/s"});
+    for (int group : {1, 16, 256, 4096}) {
+        clean();
+        Durable tree(prefix, 16);
+        tree.wal().setGroupCommit(group, 1e9);
+        double ms = measureMs([&] {
+            for (int k : shuffledKeys(n)) tree.insert(k);
+            tree.wal().sync();
+        });
+        printRow(to_string(group), {fmt(ms), to_string(tree.wal().getSyncCount()), fmt(n / ms * 1000, 0)});
+    }
+    cout << '\n';
+}
+
+void recovery() {
+    const int n = 500000;
+    cout << "== recovery (snapshot of " << n << " keys + log) ==\n";
+    printRow("log records", {"log MB", "recover ms", "replayed"});
+    for (int ops : {0, 100000, 1000000}) {
+        clean();
+        {
+            Durable tree(prefix, 16);
+            tree.wal().setGroupCommit(4096, 1e9);
+            for (int k = 0; k < n; k++) tree.insert(k);
+            tree.checkpoint();
+            mt19937 rng(5);
+            for (int i = 0; i < ops; i++) {
+                int k = rng() % (2 * n);
+                if (rng() % 2) tree.insert(k);
+                else tree.remove(k);
+            }
+        }
+        uint64_t replayed = 0;
+        double mb = 0;
+        double ms = measureMs([&] {
+            Durable tree(prefix, 16);
+            replayed = tree.getReplayedRecords();
+            mb = tree.wal().bytes() / 1024.0 / 1024.0;
+        });
+        printRow(to_string(ops), {fmt(mb), fmt(ms), to_string(replayed)});
+    }
+    cout << '\n';
+}
+
+// 같은 seed로 같은 연산열을 만든다. 중간에 한 번 체크포인트한다.
+const int ops_total = 50000, checkpoint_at = 20000, key_space = 5000;
+
+void workload(Durable& tree) {
+    mt19937 rng(11);
+    for (int i = 1; i <= ops_total; i++) {
+        int k = rng() % key_space;
+        if (rng() % 3) tree.insert(k);
+        else tree.remove(k);
+        if (i == checkpoint_at) tree.checkpoint();
+    }
+}
+
+set<int> expectedAfter(uint64_t ops) {
+    set<int> keys;
+    mt19937 rng(11);
+    for (uint64_t i = 1; i <= ops; i++) {
+        int k = rng() % key_space;
+        if (rng() % 3) keys.insert(k);
+        else keys.erase(k);
+    }
+    return keys;
+}
+
+void faultInjection() {
+    cout << "== fault injection (kill after log write, before tree update) ==\n";
+    printRow("killed at op", {"replayed", "torn tail", "check"});
+    for (uint64_t kill_at : {1, 777, 20000, 20001, 34567, 50000}) {
+        for (bool torn : {false, true}) {
+            clean();
+            pid_t pid = fork();
+            if (pid == 0) {
+                Durable tree(prefix, 4);
+                uint64_t ops = 0;
+                tree.afterLog = [&](uint64_t) {
+                    if (++ops == kill_at) raise(SIGKILL);
+                };
+                workload(tree);
+                _exit(0);
+            }
+            int status;
+            waitpid(pid, &status, 0);
+            bool killed = WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+
+            if (torn) {
+                // 다음 레코드를 쓰다 만 상태
+                FILE* f = fopen((prefix + ".wal").c_str(), "ab");
+                fputc(WriteAheadLog<int>::INSERT, f);
+                fputc(0x7f, f);
+                fclose(f);
+            }
+
+            Durable tree(prefix, 4);
+            set<int> expected = expectedAfter(kill_at);
+            bool ok = killed;
+            for (int k = 0; k < key_space; k++)
+                if (tree.search(k) != (expected.count(k) > 0)) ok = false;
+            printRow(to_string(kill_at), {to_string(tree.getReplayedRecords()), torn ? "yes" : "no", ok ? "ok" : "MISMATCH"});
+        }
+    }
+    clean();
+}
+
+int main() {
+    VisualizerConfig::setRenderEnabled(false);
+    groupCommit();
+    recovery();
+    faultInjection();
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "avltree.hpp"
+
+using namespace std;
+
+int main() {
+    VisualizerConfig::setDelayMode(DelayMode::TIME);
+    VisualizerConfig::setDelayDuration(chrono::milliseconds{500});
+
+    AVLTree<int> t;
+
+    for (int i = 0; i < 7; i++)
+        t.insert(i);
+
+    t.search(0);
+    t.search(5);
+    t.search(99);
+
+    t.remove(3);
+    t.remove(0);
+    t.remove(99);
+
+    t.rangeSearch(2, 4);
+
+    cout << "Height: " << t.height() << ", Rotations: " << t.getStats().rotations << endl;
+
+    return 0;
+}
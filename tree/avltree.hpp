@@ -0,0 +1,418 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "tree.hpp"
+#include "node.hpp"
+#include "../visualizer/visualizer.hpp"
+#include "binary_bound.hpp"
+
+using namespace std;
+
+template <typename T> class AVLTree;
+
+template <typename T>
+class AVLNode : public DataNode<T> {
+public:
+    int height = 1;
+    AVLNode<T>* parent = nullptr;
+
+    AVLNode(T val) {
+        this->key.resize(1);
+        this->key[0] = val;
+        this->key_count = 1;
+        this->children.resize(2, nullptr);
+        this->children_count = 0;
+        parent = nullptr;
+    }
+
+    AVLNode<T>* left() { return dynamic_cast<AVLNode<T>*>(this->children[0]); }
+    AVLNode<T>* right() { return dynamic_cast<AVLNode<T>*>(this->children[1]); }
+
+    void setLeft(AVLNode<T>* node) {
+        this->children[0] = node;
+        if (node) node->parent = this;
+        recountChildren();
+    }
+
+    void setRight(AVLNode<T>* node) {
+        this->children[1] = node;
+        if (node) node->parent = this;
+        recountChildren();
+    }
+
+    AVLNode<T>* minimum() {
+        AVLNode<T>* curr = this;
+        while (curr->left() != nullptr) curr = curr->left();
+        return curr;
+    }
+
+    static int heightOf(AVLNode<T>* node) { return node ? node->height : 0; }
+
+    void updateHeight() {
+        height = 1 + max(heightOf(left()), heightOf(right()));
+    }
+
+    // 왼쪽 높이 - 오른쪽 높이. |balance| > 1 이면 회전이 필요하다.
+    int balance() {
+        return heightOf(left()) - heightOf(right());
+    }
+
+    void draw(Visualizer& vis) {
+        if (this->children[1]) vis.printChild(this->children[1], Pos::UP, this, Pos::UP);
+        vis.printKey(Pos::MID_NORM, DataNode<T>::toString(this->key[0]), this, 0);
+        if (this->children[0]) vis.printChild(this->children[0], Pos::DOWN, this, Pos::DOWN);
+    }
+
+    friend class AVLTree<T>;
+
+private:
+    void recountChildren() {
+        this->children_count = (this->children[0] != nullptr) + (this->children[1] != nullptr);
+    }
+};
+
+template <typename T>
+class AVLTree : public DataTree<T> {
+public:
+    AVLTree() {}
+
+    // ---------------- Search ----------------
+    bool search(T target) {
+        this->vis->clear();
+        this->vis->setTitle("Searching for: " + DataNode<T>::toString(target));
+
+        AVLNode<T>* current = dynamic_cast<AVLNode<T>*>(this->root_ptr);
+
+        if (current == nullptr) {
+            this->vis->setMessage("Tree is empty.");
+            this->vis->render();
+            return false;
+        }
+
+        while (current != nullptr) {
+            this->stats.visited++;
+            this->vis->setColor(current, Color::YELLOW);
+            this->vis->setMessage("Comparing " + DataNode<T>::toString(current->key[0]) + " with target " + DataNode<T>::toString(target));
+            this->vis->render();
+
+            if (target == current->key[0]) {
+                this->vis->setColor(current, Color::GREEN);
+                this->vis->setMessage("Target found!");
+                this->vis->render();
+                return true;
+            }
+
+            this->vis->setColor(current, Color::RESET);
+
+            AVLNode<T>* next = (target < current->key[0]) ? current->left() : current->right();
+            if (next == nullptr) {
+                this->vis->setColor(current, Color::RED);
+                this->vis->setMessage("Reached empty child. Not found.");
+                this->vis->render();
+                return false;
+            }
+            this->vis->setMessage(string(target < current->key[0] ? "Target < Key\n-> Moving Left" : "Target > Key\n-> Moving Right"));
+            this->vis->render();
+            current = next;
+        }
+        return false;
+    }
+
+    // ---------------- Insert ----------------
+    bool insert(T key) {
+        this->vis->clear();
+        this->vis->setTitle("Inserting Key: " + DataNode<T>::toString(key));
+
+        AVLNode<T>* y = nullptr;
+        AVLNode<T>* x = dynamic_cast<AVLNode<T>*>(this->root_ptr);
+
+        this->vis->setMessage("Step 1: Standard BST Insertion");
+        this->vis->render();
+
+        while (x != nullptr) {
+            y = x;
+            this->stats.visited++;
+            this->vis->setColor(x, Color::YELLOW);
+            this->vis->setMessage("Comparing " + DataNode<T>::toString(key) + " with " + DataNode<T>::toString(x->key[0]));
+            this->vis->render();
+
+            if (key == x->key[0]) {
+                this->vis->setMessage("Key " + DataNode<T>::toString(key) + " already exists. Insertion failed.");
+                this->vis->setColor(x, Color::RED);
+                this->vis->render();
+                return false;
+            }
+
+            this->vis->setColor(x, Color::RESET);
+            x = (key < x->key[0]) ? x->left() : x->right();
+        }
+
+        AVLNode<T>* z = new AVLNode<T>(key);
+        if (y == nullptr) {
+            this->vis->setMessage("Tree is empty. Setting as Root.");
+            this->setRoot(z);
+        } else if (key < y->key[0]) {
+            this->vis->setMessage("Inserting as Left Child of " + DataNode<T>::toString(y->key[0]));
+            y->setLeft(z);
+        } else {
+            this->vis->setMessage("Inserting as Right Child of " + DataNode<T>::toString(y->key[0]));
+            y->setRight(z);
+        }
+        this->vis->setColor(z, Color::GREEN);
+        this->vis->render();
+
+        this->vis->setMessage("Step 2: Update heights and rebalance");
+        this->vis->render();
+        rebalanceFrom(y);
+
+        this->vis->clear();
+        this->vis->setMessage("Insertion Complete.");
+        this->vis->render();
+        return true;
+    }
+
+    // ---------------- Remove ----------------
+    bool remove(T key) {
+        this->vis->clear();
+        this->vis->setTitle("Removing Key: " + DataNode<T>::toString(key));
+        this->vis->render();
+
+        AVLNode<T>* z = findNodeWithVisual(key);
+        if (z == nullptr) {
+            this->vis->setMessage("Key not found. Removal failed.");
+            this->vis->render();
+            return false;
+        }
+
+        deleteNode(z);
+
+        this->vis->clear();
+        this->vis->setMessage("Removal Complete.");
+        this->vis->render();
+        return true;
+    }
+
+    // ---------------- Range Search ----------------
+    bool rangeSearch(T begin, T end) {
+        this->vis->clear();
+        this->vis->setTitle("Range Search [" + DataNode<T>::toString(begin) + ", " + DataNode<T>::toString(end) + "]");
+        this->vis->render();
+
+        if (this->root_ptr == nullptr) {
+            this->vis->setMessage("Tree is empty.");
+            this->vis->render();
+            return false;
+        }
+
+        bool found = false;
+        rangeSearchRecursive(dynamic_cast<AVLNode<T>*>(this->root_ptr), begin, end, found);
+
+        if (found) this->vis->setMessage("Range Search Finished. Green nodes are in range.");
+        else this->vis->setMessage("No nodes found in range.");
+        this->vis->render();
+
+        return found;
+    }
+
+    int height() {
+        return AVLNode<T>::heightOf(dynamic_cast<AVLNode<T>*>(this->root_ptr));
+    }
+
+protected:
+    // ---------------- Bound (Successor / Predecessor) ----------------
+
+    optional<T> bound(T x, bool greater, bool inclusive) override {
+        return this->template binaryBound<AVLNode<T>>(x, greater, inclusive,
+                                                      [this](AVLNode<T>* n) { this->vis->setColor(n, Color::RESET); });
+    }
+
+private:
+    AVLNode<T>* findNodeWithVisual(T key) {
+        AVLNode<T>* current = dynamic_cast<AVLNode<T>*>(this->root_ptr);
+        this->vis->setMessage("Searching for node to delete...");
+
+        while (current != nullptr) {
+            this->stats.visited++;
+            this->vis->setColor(current, Color::YELLOW);
+            this->vis->render();
+
+            if (key == current->key[0]) {
+                this->vis->setColor(current, Color::MAGENTA);
+                this->vis->setMessage("Found target node " + DataNode<T>::toString(key));
+                this->vis->render();
+                return current;
+            }
+
+            this->vis->setColor(current, Color::RESET);
+            current = (key < current->key[0]) ? current->left() : current->right();
+        }
+        return nullptr;
+    }
+
+    // parent의 자식 자리를 새 서브트리 루트로 교체 (루트면 트리 루트 갱신)
+    void replaceChild(AVLNode<T>* parent, AVLNode<T>* old_child, AVLNode<T>* new_child) {
+        if (parent == nullptr) {
+            this->setRoot(new_child);
+            if (new_child) new_child->parent = nullptr;
+        } else if (parent->left() == old_child) {
+            parent->setLeft(new_child);
+        } else {
+            parent->setRight(new_child);
+        }
+    }
+
+    AVLNode<T>* leftRotate(AVLNode<T>* x) {
+        this->stats.rotations++;
+        this->vis->setColor(x, Color::YELLOW);
+        this->vis->setMessage("Left Rotating around " + DataNode<T>::toString(x->key[0]));
+        this->vis->render();
+
+        AVLNode<T>* y = x->right();
+        replaceChild(x->parent, x, y);
+        x->setRight(y->left());
+        y->setLeft(x);
+
+        x->updateHeight();
+        y->updateHeight();
+
+        this->vis->setColor(x, Color::RESET);
+        this->vis->setMessage("Rotation Complete.");
+        this->vis->render();
+        return y;
+    }
+
+    AVLNode<T>* rightRotate(AVLNode<T>* y) {
+        this->stats.rotations++;
+        this->vis->setColor(y, Color::YELLOW);
+        this->vis->setMessage("Right Rotating around " + DataNode<T>::toString(y->key[0]));
+        this->vis->render();
+
+        AVLNode<T>* x = y->left();
+        replaceChild(y->parent, y, x);
+        y->setLeft(x->right());
+        x->setRight(y);
+
+        y->updateHeight();
+        x->updateHeight();
+
+        this->vis->setColor(y, Color::RESET);
+        this->vis->setMessage("Rotation Complete.");
+        this->vis->render();
+        return x;
+    }
+
+    // node부터 루트 방향으로 높이를 갱신하며 균형이 깨진 곳을 회전으로 복구한다.
+    // 서브트리 높이가 그대로면 조상의 균형도 그대로이므로 거기서 멈춘다.
+    void rebalanceFrom(AVLNode<T>* node) {
+        while (node != nullptr) {
+            int old_height = node->height;
+            node->updateHeight();
+            int bf = node->balance();
+
+            if (bf > 1) {
+                this->vis->setColor(node, Color::CYAN);
+                if (node->left()->balance() < 0) {
+                    this->vis->setMessage("Left-Right case at " + DataNode<T>::toString(node->key[0]) + ".\n-> Left Rotate left child, then Right Rotate.");
+                    this->vis->render();
+                    leftRotate(node->left());
+                } else {
+                    this->vis->setMessage("Left-Left case at " + DataNode<T>::toString(node->key[0]) + ".\n-> Right Rotate.");
+                    this->vis->render();
+                }
+                node = rightRotate(node);
+            } else if (bf < -1) {
+                this->vis->setColor(node, Color::CYAN);
+                if (node->right()->balance() > 0) {
+                    this->vis->setMessage("Right-Left case at " + DataNode<T>::toString(node->key[0]) + ".\n-> Right Rotate right child, then Left Rotate.");
+                    this->vis->render();
+                    rightRotate(node->right());
+                } else {
+                    this->vis->setMessage("Right-Right case at " + DataNode<T>::toString(node->key[0]) + ".\n-> Left Rotate.");
+                    this->vis->render();
+                }
+                node = leftRotate(node);
+            }
+
+            if (node->height == old_height) break;
+            node = node->parent;
+        }
+        this->vis->setMessage("Tree is balanced.");
+        this->vis->render();
+    }
+
+    void deleteNode(AVLNode<T>* z) {
+        AVLNode<T>* start;
+
+        if (z->left() == nullptr) {
+            this->vis->setMessage("Node has no left child. Replacing with right child.");
+            this->vis->render();
+            start = z->parent;
+            replaceChild(z->parent, z, z->right());
+        } else if (z->right() == nullptr) {
+            this->vis->setMessage("Node has no right child. Replacing with left child.");
+            this->vis->render();
+            start = z->parent;
+            replaceChild(z->parent, z, z->left());
+        } else {
+            this->vis->setMessage("Node has two children. Finding successor.");
+            this->vis->render();
+
+            AVLNode<T>* y = z->right()->minimum();
+            this->vis->setColor(y, Color::CYAN);
+            this->vis->setMessage("Successor is " + DataNode<T>::toString(y->key[0]));
+            this->vis->render();
+
+            if (y->parent == z) {
+                start = y;
+            } else {
+                start = y->parent;
+                replaceChild(y->parent, y, y->right());
+                y->setRight(z->right());
+            }
+            replaceChild(z->parent, z, y);
+            y->setLeft(z->left());
+            y->height = z->height;
+
+            this->vis->setColor(y, Color::RESET);
+            this->vis->setMessage("Replaced deleted node with Successor.");
+            this->vis->render();
+        }
+
+        delete z;
+        rebalanceFrom(start);
+    }
+
+    void rangeSearchRecursive(AVLNode<T>* node, T begin, T end, bool& found) {
+        if (node == nullptr) return;
+
+        T val = node->key[0];
+
+        if (val > begin) {
+            this->vis->setMessage("Key " + DataNode<T>::toString(val) + " > Begin (" + DataNode<T>::toString(begin) + ") -> Go Left");
+            this->vis->render();
+            rangeSearchRecursive(node->left(), begin, end, found);
+        }
+
+        this->vis->setColor(node, Color::YELLOW);
+        this->vis->setMessage("Visiting " + DataNode<T>::toString(val));
+        this->vis->render();
+
+        if (val >= begin && val <= end) {
+            this->vis->setColor(node, Color::GREEN);
+            this->vis->setMessage(DataNode<T>::toString(val) + " is in range!");
+            found = true;
+        } else {
+            this->vis->setColor(node, Color::RESET);
+            this->vis->setMessage(DataNode<T>::toString(val) + " is out of range.");
+        }
+        this->vis->render();
+
+        if (val < end) {
+            this->vis->setMessage("Key " + DataNode<T>::toString(val) + " < End (" + DataNode<T>::toString(end) + ") -> Go Right");
+            this->vis->render();
+            rangeSearchRecursive(node->right(), begin, end, found);
+        }
+    }
+};
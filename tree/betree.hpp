@@ -0,0 +1,515 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include "tree.hpp"
+#include "btree.hpp"
+#include "../visualizer/visualizer.hpp"
+
+template <typename T> class BEpsilonTree;
+
+// Bε-트리 노드. 블록 배치와 draw는 BTreeNode를 그대로 쓰고 내부 노드에 메시지 버퍼를 더한다.
+// 내부 노드의 키는 B+ 트리처럼 경로 안내용 피벗이다 (children[i]는 [key[i-1], key[i]) 범위).
+template <typename T>
+class BEpsilonNode : public BTreeNode<T> {
+public:
+    BEpsilonNode(int t, bool leaf) : BTreeNode<T>(t, leaf) {}
+
+private:
+    // (키, insert면 true / delete면 false). 키 순으로 정렬되어 있고 키마다 가장 최근 메시지 하나만 남긴다.
+    // 루트에는 뒤쪽 fresh개가 정렬 전에 덧붙인 최근 메시지다 (settle()이 정렬해 합친다).
+    vector<pair<T, bool>> buffer;
+    int fresh = 0;
+
+    friend class BEpsilonTree<T>;
+};
+
+// 쓰기 최적화 B-트리 (Bε-트리).
+// insert/remove는 루트 버퍼에 메시지를 넣기만 한다. 버퍼가 buffer_size를 넘으면 메시지가 가장 많이 몰린
+// 자식 하나로 그 메시지들을 한꺼번에 내려보내고(flush), 리프에 닿은 메시지는 모아서 한 번에 반영한다.
+// 넘치는 노드는 그때 여러 개로 나눈다. 리프까지 내려가는 비용을 여러 메시지가 나눠 내므로 무작위 insert가
+// BTree보다 훨씬 싸고, search는 내려가면서 지나는 버퍼를 먼저 본다 (위쪽 버퍼일수록 최근 메시지).
+// 키를 확인하지 않고 메시지만 넣으므로 insert/remove는 항상 true를 반환한다.
+// remove는 리프에서 키만 지우고 노드를 합치지 않는다. 비게 된 리프는 부모가 떼어 낸다.
+template <typename T>
+class BEpsilonTree : public DataTree<T> {
+public:
+    // buffer_size가 0이면 (2t)^2, 즉 팬아웃이 버퍼 크기의 제곱근인 ε = 1/2 설정이다.
+    // 클수록 insert는 싸지고 search가 훑는 버퍼가 커진다.
+    explicit BEpsilonTree(int _t, int buffer_size = 0);
+    ~BEpsilonTree();
+
+    bool search(T k);
+    bool insert(T k);
+    bool remove(T k);
+    bool rangeSearch(T begin, T end);
+
+    long long getFlushCount() const { return flushes; }
+    // 아직 리프에 반영되지 않고 버퍼에 남아 있는 메시지 수
+    size_t getBufferedCount() const { return bufferedIn(rootNode()); }
+
+protected:
+    optional<T> bound(T x, bool greater, bool inclusive) override;
+
+private:
+    using Node = BEpsilonNode<T>;
+    using Message = pair<T, bool>;
+    // 노드가 넘쳐 새로 생긴 오른쪽 형제들과 각각의 앞 구분 키
+    using Pieces = vector<pair<T, Node*>>;
+
+    int t;
+    int buffer_size;
+    // 루트 버퍼에 정렬하지 않고 덧붙여 둘 수 있는 메시지 수. 한 번 합칠 때 버퍼 전체를 옮기므로
+    // sqrt(buffer_size)면 insert당 옮기는 양과 search가 훑는 양이 비슷해진다.
+    int fresh_limit;
+    long long flushes = 0;
+
+    Node* rootNode() const { return static_cast<Node*>(this->root_ptr); }
+    static Node* child(Node* x, int i) { return static_cast<Node*>(x->childPtrs()[i]); }
+    static int childIndex(Node* x, const T& k) {
+        return int(upper_bound(x->keys().begin(), x->keys().begin() + x->keyCount(), k) - x->keys().begin());
+    }
+
+    bool upsert(T k, bool ins);
+    Pieces flush(Node* x);
+    Pieces applyToLeaf(Node* leaf, const vector<Message>& batch);
+    Pieces setChildren(Node* x, const vector<T>& pivots, const vector<Node*>& kids);
+    void growRoot(Pieces extra);
+    void shrinkRoot();
+    static void settle(Node* x);
+    static const Message* findMessage(Node* x, const T& k);
+    static void mergeMessages(vector<Message>& older, const vector<Message>& newer);
+
+    static bool contains(Node* x, const T& k);
+    static optional<T> rawBound(Node* x, const T& c, bool greater, bool inclusive);
+    void collectRange(Node* x, const T& begin, const T& end, map<T, bool>& decided);
+    static size_t bufferedIn(Node* x);
+    static void freeSubtree(Node* x);
+};
+
+template <typename T>
+BEpsilonTree<T>::BEpsilonTree(int _t, int buffer_size)
+    : t(_t),
+      buffer_size(buffer_size > 0 ? buffer_size : 4 * _t * _t),
+      fresh_limit(max(8, int(sqrt(double(this->buffer_size))))) {}
+
+template <typename T>
+BEpsilonTree<T>::~BEpsilonTree() {
+    freeSubtree(rootNode());
+}
+
+template <typename T>
+void BEpsilonTree<T>::freeSubtree(Node* x) {
+    if (x == nullptr) return;
+    if (!x->is_leaf_node())
+        for (int i = 0; i <= x->keyCount(); i++) freeSubtree(child(x, i));
+    delete x;
+}
+
+template <typename T>
+size_t BEpsilonTree<T>::bufferedIn(Node* x) {
+    if (x == nullptr || x->is_leaf_node()) return 0;
+    size_t n = x->buffer.size();
+    for (int i = 0; i <= x->keyCount(); i++) n += bufferedIn(child(x, i));
+    return n;
+}
+
+// 덧붙여 둔 최근 메시지를 정렬해 (같은 키는 나중 것만 남긴다) 정렬된 앞부분에 합친다.
+template <typename T>
+void BEpsilonTree<T>::settle(Node* x) {
+    if (x->fresh == 0) return;
+    vector<Message> recent(x->buffer.end() - x->fresh, x->buffer.end());
+    x->buffer.resize(x->buffer.size() - x->fresh);
+    x->fresh = 0;
+    stable_sort(recent.begin(), recent.end(), [](const Message& a, const Message& b) { return a.first < b.first; });
+    size_t w = 0;
+    for (size_t i = 0; i < recent.size(); i++) {
+        if (w > 0 && !(recent[w - 1].first < recent[i].first)) w--;
+        recent[w++] = recent[i];
+    }
+    recent.resize(w);
+    mergeMessages(x->buffer, recent);
+}
+
+// 부모에서 내려온 newer가 자식 버퍼의 older보다 최근이다.
+template <typename T>
+void BEpsilonTree<T>::mergeMessages(vector<Message>& older, const vector<Message>& newer) {
+    if (older.empty()) {
+        older = newer;
+        return;
+    }
+    vector<Message> merged;
+    merged.reserve(older.size() + newer.size());
+    size_t i = 0;
+    for (const Message& m : newer) {
+        while (i < older.size() && older[i].first < m.first) merged.push_back(older[i++]);
+        if (i < older.size() && !(m.first < older[i].first)) i++;
+        merged.push_back(m);
+    }
+    merged.insert(merged.end(), older.begin() + i, older.end());
+    older.swap(merged);
+}
+
+// 리프 키와 메시지를 한 번에 병합한다. 2t-1개를 넘으면 고르게 여러 리프로 나눈다.
+template <typename T>
+typename BEpsilonTree<T>::Pieces BEpsilonTree<T>::applyToLeaf(Node* leaf, const vector<Message>& batch) {
+    vector<T> merged;
+    merged.reserve(leaf->keyCount() + batch.size());
+    int i = 0;
+    for (const Message& m : batch) {
+        while (i < leaf->keyCount() && leaf->keys()[i] < m.first) merged.push_back(leaf->keys()[i++]);
+        if (i < leaf->keyCount() && !(m.first < leaf->keys()[i])) i++;
+        if (m.second) merged.push_back(m.first);
+    }
+    while (i < leaf->keyCount()) merged.push_back(leaf->keys()[i++]);
+
+    size_t cap = 2 * t - 1;
+    size_t parts = max<size_t>(1, (merged.size() + cap - 1) / cap);
+    Pieces extra;
+    size_t from = 0;
+    for (size_t p = 0; p < parts; p++) {
+        size_t to = merged.size() * (p + 1) / parts;
+        Node* n = p == 0 ? leaf : new Node(t, true);
+        for (size_t j = from; j < to; j++) n->keys()[int(j - from)] = merged[j];
+        n->keyCount() = int(to - from);
+        if (p > 0) extra.push_back({merged[from], n});
+        from = to;
+    }
+    return extra;
+}
+
+// x의 피벗/자식을 통째로 바꾼다. 자식이 2t개를 넘으면 고르게 나누고 (나뉘는 자리의 피벗은 위로 올라간다)
+// 버퍼도 피벗 기준으로 조각마다 나눠 준다. 새 조각들을 돌려준다.
+template <typename T>
+typename BEpsilonTree<T>::Pieces BEpsilonTree<T>::setChildren(Node* x, const vector<T>& pivots, const vector<Node*>& kids) {
+    size_t cap = 2 * t;
+    size_t parts = (kids.size() + cap - 1) / cap;
+    vector<Message> rest;
+    Pieces extra;
+    size_t from = 0;
+    for (size_t p = 0; p < parts; p++) {
+        size_t to = kids.size() * (p + 1) / parts;
+        Node* n = p == 0 ? x : new Node(t, false);
+        int count = int(to - from);
+        for (int j = 0; j < count - 1; j++) n->keys()[j] = pivots[from + j];
+        for (int j = 0; j < 2 * t; j++) n->childPtrs()[j] = j < count ? kids[from + j] : nullptr;
+        n->keyCount() = count - 1;
+        n->children_count = count;
+
+        if (p == 0 && parts > 1) {
+            auto cut = lower_bound(x->buffer.begin(), x->buffer.end(), pivots[to - 1],
+                                   [](const Message& a, const T& k) { return a.first < k; });
+            rest.assign(cut, x->buffer.end());
+            x->buffer.erase(cut, x->buffer.end());
+        } else if (p > 0) {
+            auto cut = p + 1 == parts ? rest.end()
+                                      : lower_bound(rest.begin(), rest.end(), pivots[to - 1],
+                                                    [](const Message& a, const T& k) { return a.first < k; });
+            n->buffer.assign(rest.begin(), cut);
+            rest.erase(rest.begin(), cut);
+            extra.push_back({pivots[from - 1], n});
+        }
+        from = to;
+    }
+    return extra;
+}
+
+// 버퍼가 넘치는 동안 메시지가 가장 많이 몰린 자식 하나씩 내려보낸다.
+// x가 나뉘면 거기서 멈추고 조각들을 돌려준다 (조각의 남은 메시지는 다음 flush 때 내려간다).
+template <typename T>
+typename BEpsilonTree<T>::Pieces BEpsilonTree<T>::flush(Node* x) {
+    auto before = [](const Message& a, const T& k) { return a.first < k; };
+    settle(x);
+    while ((int)x->buffer.size() > buffer_size) {
+        // 버퍼와 피벗이 모두 정렬되어 있으므로 자식별 메시지 구간을 한 번에 나눌 수 있다.
+        int kc = x->keyCount(), best = 0;
+        size_t best_lo = 0, best_hi = 0, lo = 0;
+        for (int i = 0; i <= kc; i++) {
+            size_t hi = i == kc ? x->buffer.size()
+                                : lower_bound(x->buffer.begin() + lo, x->buffer.end(), x->keys()[i], before) - x->buffer.begin();
+            if (hi - lo > best_hi - best_lo) {
+                best = i;
+                best_lo = lo;
+                best_hi = hi;
+            }
+            lo = hi;
+        }
+        vector<Message> batch(x->buffer.begin() + best_lo, x->buffer.begin() + best_hi);
+        x->buffer.erase(x->buffer.begin() + best_lo, x->buffer.begin() + best_hi);
+        flushes++;
+
+        Node* c = child(x, best);
+        this->vis->setColor(c, Color::YELLOW);
+        this->vis->setMessage("Flushing " + to_string(batch.size()) + " messages to child " + to_string(best) + ".");
+        this->vis->render();
+        this->vis->setColor(c, Color::RESET);
+
+        Pieces extra;
+        if (c->is_leaf_node()) {
+            extra = applyToLeaf(c, batch);
+        } else {
+            mergeMessages(c->buffer, batch);
+            if ((int)c->buffer.size() > buffer_size) extra = flush(c);
+        }
+        bool drop = c->is_leaf_node() && c->keyCount() == 0 && kc > 0;
+        if (extra.empty() && !drop) continue;
+
+        vector<T> pivots(x->keys().begin(), x->keys().begin() + kc);
+        vector<Node*> kids;
+        for (int i = 0; i <= kc; i++) kids.push_back(child(x, i));
+        if (drop) {
+            // 빈 리프를 떼면 그 범위는 이웃 자식이 맡는다.
+            kids.erase(kids.begin() + best);
+            pivots.erase(pivots.begin() + (best == 0 ? 0 : best - 1));
+            delete c;
+        } else {
+            for (size_t j = 0; j < extra.size(); j++) {
+                pivots.insert(pivots.begin() + best + j, extra[j].first);
+                kids.insert(kids.begin() + best + 1 + j, extra[j].second);
+            }
+        }
+        Pieces mine = setChildren(x, pivots, kids);
+        if (!mine.empty()) return mine;
+    }
+    return {};
+}
+
+template <typename T>
+void BEpsilonTree<T>::growRoot(Pieces extra) {
+    while (!extra.empty()) {
+        this->vis->setMessage("Root split. Growing tree height.");
+        vector<T> pivots;
+        vector<Node*> kids{rootNode()};
+        for (auto& [sep, n] : extra) {
+            pivots.push_back(sep);
+            kids.push_back(n);
+        }
+        Node* s = new Node(t, false);
+        this->setRoot(s);
+        extra = setChildren(s, pivots, kids);
+    }
+}
+
+// 자식 하나만 남고 버퍼도 빈 내부 루트, 빈 리프 루트를 걷어 낸다.
+template <typename T>
+void BEpsilonTree<T>::shrinkRoot() {
+    Node* r = rootNode();
+    while (r != nullptr && !r->is_leaf_node() && r->keyCount() == 0 && r->buffer.empty()) {
+        Node* only = child(r, 0);
+        delete r;
+        this->setRoot(only);
+        r = only;
+    }
+    if (r != nullptr && r->is_leaf_node() && r->keyCount() == 0) {
+        delete r;
+        this->setRoot(nullptr);
+    }
+}
+
+template <typename T>
+bool BEpsilonTree<T>::upsert(T k, bool ins) {
+    Node* r = rootNode();
+    if (r == nullptr) {
+        if (!ins) {
+            this->vis->setMessage("Tree is empty.");
+            this->vis->render();
+            return true;
+        }
+        this->vis->setMessage("Tree is empty. Creating root.");
+        r = new Node(t, true);
+        r->keys()[0] = k;
+        r->keyCount() = 1;
+        this->setRoot(r);
+        this->vis->setColor(r, 0, Color::GREEN);
+        this->vis->render();
+        return true;
+    }
+
+    Pieces extra;
+    if (r->is_leaf_node()) {
+        this->vis->setMessage("Root is a leaf. Applying directly.");
+        extra = applyToLeaf(r, {{k, ins}});
+    } else {
+        r->buffer.push_back({k, ins});
+        if (++r->fresh >= fresh_limit) settle(r);
+        this->vis->setColor(r, Color::YELLOW);
+        this->vis->setMessage("Buffered at root.");
+        this->vis->render();
+        this->vis->setColor(r, Color::RESET);
+        if ((int)r->buffer.size() > buffer_size) extra = flush(r);
+    }
+    growRoot(move(extra));
+    shrinkRoot();
+
+    this->vis->clear();
+    this->vis->render();
+    return true;
+}
+
+template <typename T>
+bool BEpsilonTree<T>::insert(T k) {
+    this->vis->clear();
+    this->vis->setTitle("Inserting: " + DataNode<T>::toString(k));
+    return upsert(k, true);
+}
+
+template <typename T>
+bool BEpsilonTree<T>::remove(T k) {
+    this->vis->clear();
+    this->vis->setTitle("Removing: " + DataNode<T>::toString(k));
+    return upsert(k, false);
+}
+
+// 위쪽 버퍼에서 먼저 만난 메시지가 답이다. 어느 버퍼에도 없으면 리프를 본다.
+// 덧붙여 둔 최근 메시지를 뒤에서부터 먼저 보고, 없으면 정렬된 부분을 이분 탐색한다.
+template <typename T>
+const typename BEpsilonTree<T>::Message* BEpsilonTree<T>::findMessage(Node* x, const T& k) {
+    const Message* first = x->buffer.data();
+    const Message* sorted_end = first + x->buffer.size() - x->fresh;
+    for (const Message* m = first + x->buffer.size(); m != sorted_end; --m)
+        if (m[-1].first == k) return m - 1;
+    const Message* it = lower_bound(first, sorted_end, k, [](const Message& a, const T& key) { return a.first < key; });
+    return it != sorted_end && !(k < it->first) ? it : nullptr;
+}
+
+template <typename T>
+bool BEpsilonTree<T>::search(T k) {
+    this->vis->clear();
+    this->vis->setTitle("Searching for: " + DataNode<T>::toString(k));
+    Node* x = rootNode();
+    if (x == nullptr) {
+        this->vis->setMessage("Tree is empty.");
+        this->vis->render();
+        return false;
+    }
+
+    while (!x->is_leaf_node()) {
+        this->stats.visited++;
+        this->vis->setColor(x, Color::YELLOW);
+        this->vis->render();
+        const Message* it = findMessage(x, k);
+        if (it != nullptr) {
+            this->vis->setMessage(it->second ? "Found a buffered insert." : "Found a buffered delete.");
+            this->vis->setColor(x, it->second ? Color::GREEN : Color::RED);
+            this->vis->render();
+            return it->second;
+        }
+        x = child(x, childIndex(x, k));
+    }
+    this->stats.visited++;
+    int i = int(lower_bound(x->keys().begin(), x->keys().begin() + x->keyCount(), k) - x->keys().begin());
+    bool found = i < x->keyCount() && !(k < x->keys()[i]);
+    if (found) {
+        this->vis->setColor(x, i, Color::GREEN);
+        this->vis->setMessage("Key found in leaf.");
+    } else {
+        this->vis->setColor(x, Color::RED);
+        this->vis->setMessage("Key not found.");
+    }
+    this->vis->render();
+    return found;
+}
+
+// search와 같은 판정을 시각화 없이 한다.
+template <typename T>
+bool BEpsilonTree<T>::contains(Node* x, const T& k) {
+    while (!x->is_leaf_node()) {
+        const Message* it = findMessage(x, k);
+        if (it != nullptr) return it->second;
+        x = child(x, childIndex(x, k));
+    }
+    int i = int(lower_bound(x->keys().begin(), x->keys().begin() + x->keyCount(), k) - x->keys().begin());
+    return i < x->keyCount() && !(k < x->keys()[i]);
+}
+
+// 메시지든 리프 키든 c 쪽으로 가장 가까운 항목의 키. 지워진 키일 수도 있으므로 bound가 다시 확인한다.
+// 버퍼는 서브트리 전체 범위를 덮으므로 버퍼 후보와 (c가 속한 자식부터 그 방향으로) 처음 답이 있는 자식의 후보 중 가까운 쪽이다.
+template <typename T>
+optional<T> BEpsilonTree<T>::rawBound(Node* x, const T& c, bool greater, bool inclusive) {
+    auto better = [&](const optional<T>& a, const optional<T>& b) -> optional<T> {
+        if (!a) return b;
+        if (!b) return a;
+        return greater ? min(*a, *b) : max(*a, *b);
+    };
+    auto pick = [&](auto first, auto last, auto keyOf) -> optional<T> {
+        // [first, last)는 정렬되어 있다.
+        if (greater) {
+            auto it = inclusive ? lower_bound(first, last, c, [&](const auto& e, const T& v) { return keyOf(e) < v; })
+                                : upper_bound(first, last, c, [&](const T& v, const auto& e) { return v < keyOf(e); });
+            if (it == last) return nullopt;
+            return keyOf(*it);
+        }
+        auto it = inclusive ? upper_bound(first, last, c, [&](const T& v, const auto& e) { return v < keyOf(e); })
+                            : lower_bound(first, last, c, [&](const auto& e, const T& v) { return keyOf(e) < v; });
+        if (it == first) return nullopt;
+        return keyOf(*(it - 1));
+    };
+
+    if (x->is_leaf_node())
+        return pick(x->keys().begin(), x->keys().begin() + x->keyCount(), [](const T& k) { return k; });
+
+    optional<T> best = pick(x->buffer.begin(), x->buffer.end(), [](const Message& m) { return m.first; });
+    for (int i = childIndex(x, c); i >= 0 && i <= x->keyCount(); i += greater ? 1 : -1) {
+        optional<T> sub = rawBound(child(x, i), c, greater, inclusive);
+        if (sub) return better(best, sub);
+    }
+    return best;
+}
+
+template <typename T>
+optional<T> BEpsilonTree<T>::bound(T x, bool greater, bool inclusive) {
+    this->vis->clear();
+    this->vis->setTitle(this->boundTitle(greater, inclusive) + " of: " + DataNode<T>::toString(x));
+    Node* r = rootNode();
+    if (r == nullptr) return nullopt;
+    if (!r->is_leaf_node()) settle(r);
+
+    optional<T> cand = rawBound(r, x, greater, inclusive);
+    while (cand && !contains(r, *cand)) {
+        this->stats.visited++;
+        cand = rawBound(r, *cand, greater, false);
+    }
+    this->vis->setMessage(cand ? "Result: " + DataNode<T>::toString(*cand) : string("No such key."));
+    this->vis->render();
+    return cand;
+}
+
+// 위에서 아래로 훑으면서 키마다 처음 본 (가장 최근) 판정만 남긴다. 형제 서브트리는 범위가 겹치지 않는다.
+template <typename T>
+void BEpsilonTree<T>::collectRange(Node* x, const T& begin, const T& end, map<T, bool>& decided) {
+    this->stats.visited++;
+    this->vis->setColor(x, Color::YELLOW);
+    this->vis->render();
+    this->vis->setColor(x, Color::RESET);
+    if (x->is_leaf_node()) {
+        for (int i = 0; i < x->keyCount(); i++)
+            if (!(x->keys()[i] < begin) && !(end < x->keys()[i])) decided.insert({x->keys()[i], true});
+        return;
+    }
+    for (const Message& m : x->buffer)
+        if (!(m.first < begin) && !(end < m.first)) decided.insert(m);
+    for (int i = childIndex(x, begin); i <= x->keyCount(); i++) {
+        collectRange(child(x, i), begin, end, decided);
+        if (i < x->keyCount() && end < x->keys()[i]) break;
+    }
+}
+
+template <typename T>
+bool BEpsilonTree<T>::rangeSearch(T begin, T end) {
+    this->vis->clear();
+    this->vis->setTitle("Range Search [" + DataNode<T>::toString(begin) + ", " + DataNode<T>::toString(end) + "]");
+    if (rootNode() == nullptr) return false;
+    if (!rootNode()->is_leaf_node()) settle(rootNode());
+
+    map<T, bool> decided;
+    collectRange(rootNode(), begin, end, decided);
+    int found = 0;
+    for (auto& [k, present] : decided) found += present;
+    this->vis->setMessage("Found " + to_string(found) + " keys in range.");
+    this->vis->render();
+    return found > 0;
+}
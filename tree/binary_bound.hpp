@@ -0,0 +1,47 @@
+#pragma once
+#include <optional>
+#include "tree.hpp"
+#include "node.hpp"
+#include "../visualizer/visualizer.hpp"
+
+// DataTree::binaryBound 정의. 시각화 호출이 있어 Visualizer가 완전한 타입인 곳에 둔다.
+template <typename T>
+template <typename N, typename Restore>
+std::optional<T> DataTree<T>::binaryBound(T x, bool greater, bool inclusive, Restore restore) {
+    this->vis->clear();
+    this->vis->setTitle(boundTitle(greater, inclusive) + " of: " + DataNode<T>::toString(x));
+
+    N* best = nullptr;
+    N* current = dynamic_cast<N*>(this->root_ptr);
+    while (current != nullptr) {
+        stats.visited++;
+        T k = current->key[0];
+        this->vis->setColor(current, Color::YELLOW);
+        this->vis->render();
+        restore(current);
+
+        if (inclusive && k == x) {
+            best = current;
+            break;
+        }
+        bool fits = greater ? k > x : k < x;
+        if (fits) {
+            best = current;
+            this->vis->setMessage("Candidate " + DataNode<T>::toString(k) + ". Looking for a closer key.");
+        } else {
+            this->vis->setMessage(DataNode<T>::toString(k) + " is on the wrong side of " + DataNode<T>::toString(x) + ".");
+        }
+        this->vis->render();
+        current = dynamic_cast<N*>(current->children[(greater == fits) ? 0 : 1]);
+    }
+
+    if (best == nullptr) {
+        this->vis->setMessage("No such key.");
+        this->vis->render();
+        return std::nullopt;
+    }
+    this->vis->setColor(best, Color::GREEN);
+    this->vis->setMessage("Result: " + DataNode<T>::toString(best->key[0]));
+    this->vis->render();
+    return best->key[0];
+}
\ No newline at end of file
@@ -0,0 +1,392 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+
+using namespace std;
+
+// 여러 스레드가 동시에 읽고 쓰는 B+ 트리 (Lehman-Yao B-link 트리).
+// 리프뿐 아니라 모든 노드에 오른쪽 형제 링크 right와 high key가 있다.
+// 노드는 [왼쪽 형제의 high, high) 구간을 맡고, 찾는 키가 high 이상이면 right로 옮겨 간다.
+// split은 형제를 만들어 right로 먼저 걸고 부모에는 나중에 separator를 넣으므로,
+// 그 사이에 옛 노드로 내려온 스레드도 오른쪽으로 옮겨 가면 키를 찾는다.
+//
+// 래치는 노드마다 version 한 word다 (홀수 = 누가 고치는 중).
+//  - 조회는 래치를 잡지 않는다. version을 읽고, 노드를 읽고, version이 그대로인지 확인한다.
+//    바뀌었으면 그 노드만 다시 읽는다 (루트부터 다시 내려가지 않고, 쓰기를 막지도 않는다).
+//  - 쓰기는 고칠 노드만 잠근다. 오른쪽으로 옮길 때와 split할 때만 두 개를 잡고,
+//    부모로 올라가기 전에 자식을 푼다. 그래서 한 스레드가 동시에 잡는 래치는 최대 두 개다.
+// remove는 노드를 합치지 않는다 (Lehman-Yao와 같다. 빈 리프가 남을 수 있다).
+// 노드는 트리가 없어질 때 한꺼번에 해제하므로 다른 스레드가 읽는 중인 노드가 사라지는 일은 없다.
+// 키를 atomic<T>로 두므로 T는 trivially copyable이어야 한다. 시각화는 지원하지 않는다.
+// 빌드: -pthread
+template <typename T>
+class BLinkTree {
+    static_assert(is_trivially_copyable<T>::value, "BLinkTree needs a trivially copyable key type");
+
+public:
+    // 노드당 키는 BPlusTree와 같이 최대 2t-1개
+    explicit BLinkTree(int t = 16) : cap(2 * max(t, 2) - 1) {
+        Node* leaf = newNode(true, 0);
+        unlock(leaf);
+        root.store(leaf, memory_order_release);
+    }
+    ~BLinkTree();
+    BLinkTree(const BLinkTree&) = delete;
+    BLinkTree& operator=(const BLinkTree&) = delete;
+
+    bool search(T k) const {
+        const Node* n = root.load(memory_order_acquire);
+        while (true) {
+            Step s = readNode(n, [&] { return step(n, k); });
+            if (s.next == nullptr) return s.found;
+            n = s.next;
+        }
+    }
+
+    optional<T> lowerBound(T k) const {
+        optional<T> found;
+        rangeScanFrom(k, nullopt, [&](T x) {
+            found = x;
+            return false;
+        });
+        return found;
+    }
+
+    // [begin, end] 안의 키를 순서대로 f에 넘긴다. 하나라도 있었는지 반환.
+    // 리프 하나씩은 일관된 상태를 읽지만, 범위 전체가 한 시점의 스냅샷은 아니다.
+    template <typename F>
+    bool rangeScan(T begin, T end, F f) const {
+        bool found_any = false;
+        rangeScanFrom(begin, end, [&](T x) {
+            if (end < x) return false;
+            f(x);
+            found_any = true;
+            return true;
+        });
+        return found_any;
+    }
+    bool rangeSearch(T begin, T end) const {
+        return rangeScan(begin, end, [](T) {});
+    }
+
+    bool insert(T k);
+    bool remove(T k);
+
+    size_t size() const { return key_count.load(memory_order_relaxed); }
+    int height() const { return root.load(memory_order_acquire)->level + 1; }
+
+private:
+    struct Node {
+        atomic<uint64_t> version{1};  // 만들 때는 잠긴 상태다. 만든 스레드가 다 채우고 푼다.
+        const bool leaf;
+        const int level;  // 리프가 0
+        atomic<int> count{0};
+        atomic<bool> bounded{false};  // false면 high = +inf (그 층의 맨 오른쪽 노드)
+        atomic<T> high{};
+        atomic<Node*> right{nullptr};
+        unique_ptr<atomic<T>[]> keys;          // 내부 노드: left < keys[i] <= right
+        unique_ptr<atomic<Node*>[]> children;  // 내부 노드만, count + 1개
+
+        Node(bool leaf, int level, int cap)
+            : leaf(leaf), level(level), keys(new atomic<T>[cap]()),
+              children(leaf ? nullptr : new atomic<Node*>[cap + 1]()) {}
+
+        T key(int i) const { return keys[i].load(memory_order_relaxed); }
+        Node* child(int i) const { return children[i].load(memory_order_acquire); }
+        bool covers(T k) const {
+            return !bounded.load(memory_order_relaxed) || k < high.load(memory_order_relaxed);
+        }
+    };
+
+    // 노드 하나를 읽은 결과. next가 있으면 그쪽(오른쪽 형제나 자식)으로 간다.
+    struct Step {
+        Node* next = nullptr;
+        bool down = false;
+        bool found = false;
+    };
+
+    const int cap;
+    atomic<Node*> root{nullptr};
+    atomic<size_t> key_count{0};
+
+    Node* newNode(bool leaf, int level) { return new Node(leaf, level, cap); }
+
+    // 조회 중에는 다른 스레드가 고치는 중인 값을 읽을 수 있으므로 count를 배열 크기 안으로 자른다.
+    // 그런 값은 readNode가 version 확인에서 버린다.
+    int countOf(const Node* n) const { return min(max(n->count.load(memory_order_relaxed), 0), cap); }
+
+    // 첫 번째 k 이상 키의 위치
+    int lowerIndex(const Node* n, T k) const {
+        int lo = 0, hi = countOf(n);
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (n->key(mid) < k) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+    // k가 내려갈 자식 (k 이하 키의 수)
+    int childIndex(const Node* n, T k) const {
+        int lo = 0, hi = countOf(n);
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (k < n->key(mid)) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    Step step(const Node* n, T k) const {
+        Step s;
+        if (!n->covers(k)) {
+            s.next = n->right.load(memory_order_acquire);
+        } else if (n->leaf) {
+            int i = lowerIndex(n, k);
+            s.found = i < countOf(n) && !(k < n->key(i));
+        } else {
+            s.next = n->child(childIndex(n, k));
+            s.down = true;
+        }
+        return s;
+    }
+
+    static void backoff(int spins) {
+        if (spins > 32) this_thread::yield();
+    }
+
+    // 래치 없이 read()로 노드를 읽는다. 읽는 사이 version이 바뀌었으면 다시 읽는다.
+    template <typename F>
+    static auto readNode(const Node* n, F read) -> decltype(read()) {
+        for (int spins = 0;; spins++) {
+            uint64_t v = n->version.load(memory_order_acquire);
+            if (!(v & 1)) {
+                auto r = read();
+                atomic_thread_fence(memory_order_acquire);
+                if (n->version.load(memory_order_relaxed) == v) return r;
+            }
+            backoff(spins);
+        }
+    }
+
+    static void lock(Node* n) {
+        for (int spins = 0;; spins++) {
+            uint64_t v = n->version.load(memory_order_relaxed);
+            if (!(v & 1) && n->version.compare_exchange_weak(v, v + 1, memory_order_acquire)) break;
+            backoff(spins);
+        }
+        // 이후의 쓰기가 version을 홀수로 바꾸기 전에 보이지 않게 한다 (seqlock)
+        atomic_thread_fence(memory_order_release);
+    }
+    static void unlock(Node* n) { n->version.fetch_add(1, memory_order_release); }
+
+    // 잠근 노드 n에서 k를 맡은 노드까지 오른쪽으로 옮겨 간다. 다음 노드를 잡은 뒤 앞 노드를 푼다.
+    static Node* moveRight(Node* n, T k) {
+        while (!n->covers(k)) {
+            Node* r = n->right.load(memory_order_acquire);
+            lock(r);
+            unlock(n);
+            n = r;
+        }
+        return n;
+    }
+
+    // k가 있을 리프까지 래치 없이 내려간다. path에는 층마다 내려온 내부 노드를 쌓는다.
+    Node* descend(T k, vector<Node*>* path) const {
+        Node* n = root.load(memory_order_acquire);
+        while (!n->leaf) {
+            Step s = readNode(n, [&] { return step(n, k); });
+            if (s.down && path) path->push_back(n);
+            n = s.next;
+        }
+        return n;
+    }
+
+    // 루트부터 level 층까지 내려가 k를 맡은 (또는 그 왼쪽의) 노드를 찾는다.
+    // 내려오는 동안 루트가 자라서 path가 모자랄 때 부모를 찾는 데 쓴다.
+    Node* findAtLevel(T k, int level) const {
+        Node* n = root.load(memory_order_acquire);
+        while (n->level > level) n = readNode(n, [&] { return step(n, k); }).next;
+        return n;
+    }
+
+    // 꽉 찬 잠긴 노드 n을 반으로 나눈다. 새 형제는 잠긴 채로 n->right에 걸어서 돌려준다.
+    Node* split(Node* n, T& sep);
+    // 잠긴 노드에 키(내부 노드면 키와 그 오른쪽 자식)를 넣는다. 자리가 있어야 한다.
+    void insertAt(Node* n, T k, Node* right_child);
+    // n을 split해 생긴 (sep, sib)을 부모에 넣는다. n은 잠긴 채로 받아서 풀고 돌아온다.
+    void insertParent(Node* n, T sep, Node* sib, vector<Node*>& path);
+
+    // from 이상 키를 순서대로 f에 넘긴다. f가 false를 돌려주거나 high가 until을 넘는 노드까지 보면 멈춘다.
+    template <typename F>
+    void rangeScanFrom(T from, optional<T> until, F f) const {
+        vector<T> buf;
+        buf.reserve(cap);
+        const Node* n = descend(from, nullptr);
+        while (n != nullptr) {
+            Step s = readNode(n, [&] {
+                buf.clear();
+                Step r;
+                if (!n->covers(from)) {
+                    r.next = n->right.load(memory_order_acquire);
+                    return r;
+                }
+                for (int i = lowerIndex(n, from), c = countOf(n); i < c; i++) buf.push_back(n->key(i));
+                // high 이상 키는 오른쪽 노드에 있으므로 다음에는 high부터 본다
+                r.found = n->bounded.load(memory_order_relaxed);
+                if (r.found) {
+                    r.next = n->right.load(memory_order_acquire);
+                    buf.push_back(n->high.load(memory_order_relaxed));
+                }
+                return r;
+            });
+            if (s.found) {
+                from = buf.back();
+                buf.pop_back();
+            }
+            for (T k : buf)
+                if (!f(k)) return;
+            if (s.found && until && *until < from) return;
+            n = s.next;
+        }
+    }
+};
+
+template <typename T>
+BLinkTree<T>::~BLinkTree() {
+    // 층마다 맨 왼쪽 노드에서 right를 따라가며 지운다
+    Node* first = root.load(memory_order_relaxed);
+    while (first != nullptr) {
+        Node* below = first->leaf ? nullptr : first->child(0);
+        for (Node* n = first; n != nullptr;) {
+            Node* r = n->right.load(memory_order_relaxed);
+            delete n;
+            n = r;
+        }
+        first = below;
+    }
+}
+
+template <typename T>
+bool BLinkTree<T>::insert(T k) {
+    vector<Node*> path;
+    Node* n = descend(k, &path);
+    lock(n);
+    n = moveRight(n, k);
+
+    int i = lowerIndex(n, k);
+    if (i < n->count.load(memory_order_relaxed) && !(k < n->key(i))) {
+        unlock(n);
+        return false;
+    }
+    key_count.fetch_add(1, memory_order_relaxed);
+    if (n->count.load(memory_order_relaxed) < cap) {
+        insertAt(n, k, nullptr);
+        unlock(n);
+        return true;
+    }
+
+    T sep;
+    Node* sib = split(n, sep);
+    insertAt(k < sep ? n : sib, k, nullptr);
+    unlock(sib);
+    insertParent(n, sep, sib, path);
+    return true;
+}
+
+template <typename T>
+bool BLinkTree<T>::remove(T k) {
+    Node* n = descend(k, nullptr);
+    lock(n);
+    n = moveRight(n, k);
+
+    int c = n->count.load(memory_order_relaxed);
+    int i = lowerIndex(n, k);
+    bool found = i < c && !(k < n->key(i));
+    if (found) {
+        for (int j = i; j + 1 < c; j++) n->keys[j].store(n->key(j + 1), memory_order_relaxed);
+        n->count.store(c - 1, memory_order_relaxed);
+        key_count.fetch_sub(1, memory_order_relaxed);
+    }
+    unlock(n);
+    return found;
+}
+
+template <typename T>
+typename BLinkTree<T>::Node* BLinkTree<T>::split(Node* n, T& sep) {
+    Node* sib = newNode(n->leaf, n->level);
+    int mid = cap / 2;
+    sep = n->key(mid);
+    // 리프는 sep도 오른쪽에 남기고, 내부 노드는 sep을 부모로 올린다
+    int from = n->leaf ? mid : mid + 1;
+    for (int i = from; i < cap; i++) sib->keys[i - from].store(n->key(i), memory_order_relaxed);
+    if (!n->leaf)
+        for (int i = from; i <= cap; i++) sib->children[i - from].store(n->child(i), memory_order_release);
+    sib->count.store(cap - from, memory_order_relaxed);
+    sib->bounded.store(n->bounded.load(memory_order_relaxed), memory_order_relaxed);
+    sib->high.store(n->high.load(memory_order_relaxed), memory_order_relaxed);
+    sib->right.store(n->right.load(memory_order_relaxed), memory_order_release);
+
+    n->count.store(mid, memory_order_relaxed);
+    n->high.store(sep, memory_order_relaxed);
+    n->bounded.store(true, memory_order_relaxed);
+    n->right.store(sib, memory_order_release);
+    return sib;
+}
+
+template <typename T>
+void BLinkTree<T>::insertAt(Node* n, T k, Node* right_child) {
+    int c = n->count.load(memory_order_relaxed);
+    int i = n->leaf ? lowerIndex(n, k) : childIndex(n, k);
+    for (int j = c; j > i; j--) {
+        n->keys[j].store(n->key(j - 1), memory_order_relaxed);
+        if (!n->leaf) n->children[j + 1].store(n->child(j), memory_order_release);
+    }
+    n->keys[i].store(k, memory_order_relaxed);
+    if (!n->leaf) n->children[i + 1].store(right_child, memory_order_release);
+    n->count.store(c + 1, memory_order_relaxed);
+}
+
+template <typename T>
+void BLinkTree<T>::insertParent(Node* n, T sep, Node* sib, vector<Node*>& path) {
+    while (true) {
+        Node* parent;
+        if (!path.empty()) {
+            parent = path.back();
+            path.pop_back();
+        } else if (n == root.load(memory_order_acquire)) {
+            // n이 잠겨 있으므로 다른 스레드가 그 사이 루트를 바꿀 수 없다
+            Node* r = newNode(false, n->level + 1);
+            r->keys[0].store(sep, memory_order_relaxed);
+            r->children[0].store(n, memory_order_release);
+            r->children[1].store(sib, memory_order_release);
+            r->count.store(1, memory_order_relaxed);
+            unlock(r);
+            root.store(r, memory_order_release);
+            unlock(n);
+            return;
+        } else {
+            parent = findAtLevel(sep, n->level + 1);
+        }
+        unlock(n);
+
+        lock(parent);
+        parent = moveRight(parent, sep);
+        if (parent->count.load(memory_order_relaxed) < cap) {
+            insertAt(parent, sep, sib);
+            unlock(parent);
+            return;
+        }
+        T up;
+        Node* psib = split(parent, up);
+        insertAt(sep < up ? parent : psib, sep, sib);
+        unlock(psib);
+        n = parent;
+        sep = up;
+        sib = psib;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// 블록 Bloom 필터 통계. hitRate는 필터만으로 끝난 조회 비율,
+// falsePositiveRate는 실제로 없는 키 중 필터를 통과해 트리까지 내려간 비율이다.
+struct BloomStats {
+    uint64_t queries = 0;
+    uint64_t rejected = 0;         // "확실히 없음"으로 바로 돌려보낸 조회
+    uint64_t false_positives = 0;  // 필터는 통과했지만 트리에 없던 조회
+    size_t bits = 0;
+    int hashes = 0;
+    uint64_t rebuilds = 0;
+
+    double hitRate() const { return queries ? double(rejected) / queries : 0; }
+    double falsePositiveRate() const {
+        uint64_t absent = rejected + false_positives;
+        return absent ? double(false_positives) / absent : 0;
+    }
+};
+
+// 캐시 라인(512비트) 단위 블록 Bloom 필터. 키 하나의 비트는 모두 한 블록에 있으므로
+// 조회는 캐시 miss 한 번으로 끝난다 (대신 같은 크기의 일반 Bloom 필터보다 FPR이 약간 높다).
+// 비트를 지울 수 없으므로 remove는 세어 두기만 하고, 지워진 키가 많아지거나 capacity를 넘게
+// 채워지면 needsRebuild()가 true가 된다. 그때 트리가 남은 키로 rebuild()한다.
+// fpr은 capacity개가 들어 있을 때의 목표값이다 (rebuild는 키 수의 두 배로 잡으므로 보통 그보다 낮다).
+template <typename T>
+class BloomFilter {
+public:
+    BloomFilter(size_t capacity, double fpr) : fpr(min(max(fpr, 1e-6), 0.5)) { reset(capacity); }
+
+    void add(const T& k) {
+        uint64_t h = hashOf(k);
+        uint64_t* block = blockOf(h);
+        uint64_t g = h * 0x9e3779b97f4a7c15ull;  // 블록 선택과 다른 비트를 쓰도록 한 번 더 섞는다
+        uint32_t h1 = uint32_t(g), h2 = uint32_t(g >> 32) | 1;
+        for (int i = 0; i < hashes; i++) {
+            uint32_t bit = (h1 + i * h2) & 511;
+            block[bit >> 6] |= 1ull << (bit & 63);
+        }
+        added++;
+    }
+
+    // false면 k는 확실히 없다.
+    bool mayContain(const T& k) {
+        stats.queries++;
+        uint64_t h = hashOf(k);
+        const uint64_t* block = blockOf(h);
+        uint64_t g = h * 0x9e3779b97f4a7c15ull;
+        uint32_t h1 = uint32_t(g), h2 = uint32_t(g >> 32) | 1;
+        bool all = true;
+        for (int i = 0; i < hashes; i++) {
+            uint32_t bit = (h1 + i * h2) & 511;
+            all &= (block[bit >> 6] >> (bit & 63)) & 1;
+        }
+        if (!all) stats.rejected++;
+        return all;
+    }
+
+    void noteFalsePositive() { stats.false_positives++; }
+    void noteRemoved() { removed++; }
+
+    bool needsRebuild() const { return added > capacity || removed * 2 > added; }
+
+    // 남은 키로 다시 채운다. 크기는 키 수의 두 배로 잡아 다음 rebuild까지 여유를 둔다.
+    void rebuild(const vector<T>& keys) {
+        reset(max(keys.size() * 2, capacity));
+        for (const T& k : keys) add(k);
+        stats.rebuilds++;
+    }
+
+    BloomStats getStats() const {
+        BloomStats s = stats;
+        s.bits = words.size() * 64;
+        s.hashes = hashes;
+        return s;
+    }
+    void resetStats() {
+        uint64_t rebuilds = stats.rebuilds;
+        stats = BloomStats{};
+        stats.rebuilds = rebuilds;
+    }
+
+    double targetFpr() const { return fpr; }
+
+private:
+    double fpr;
+    size_t capacity = 0;
+    size_t blocks = 0;
+    int hashes = 1;
+    vector<uint64_t> words;  // 블록마다 8개
+    size_t added = 0;
+    size_t removed = 0;
+    BloomStats stats;
+
+    // 키당 비트 수 -ln(p)/ln(2)^2, 해시 수 -log2(p)
+    void reset(size_t new_capacity) {
+        capacity = max<size_t>(new_capacity, 64);
+        double bits_per_key = -log(fpr) / (log(2.0) * log(2.0));
+        blocks = max<size_t>(1, size_t(ceil(capacity * bits_per_key / 512)));
+        hashes = max(1, int(lround(-log2(fpr))));
+        words.assign(blocks * 8, 0);
+        added = removed = 0;
+    }
+
+    static uint64_t hashOf(const T& k) {
+        uint64_t x = hash<T>{}(k);
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    // 위쪽 비트로 블록을 고른다 (곱셈으로 [0, blocks) 범위에 맞춘다).
+    uint64_t* blockOf(uint64_t h) {
+        return words.data() + size_t((unsigned __int128)h * blocks >> 64) * 8;
+    }
+};
@@ -1,31 +1,39 @@
 #pragma once
 #include <iostream>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <memory>
 #include "tree.hpp"
 #include "node.hpp"
+#include "snapshot.hpp"
+#include "bloom_filter.hpp"
 #include "../visualizer/visualizer.hpp"
 
 using namespace std;
 
 template <typename T> class BPlusTree;
+template <typename T> class LearnedBPlusTree;
+template <typename T> class LSMTree;
 
 template <typename T>
 class BPlusTreeNode : public DataNode<T> {
     int t; // Minimum degree
     BPlusTreeNode<T>* next; // 리프 노드 연결을 위한 포인터
+    vector<bool> tombstone; // lazy delete 모드에서 삭제 표시된 리프 키
 
 public:
     BPlusTreeNode(int _t, bool leaf);
 
-    bool search(T k, Visualizer& vis);
+    bool search(T k, Visualizer& vis, bool prefetch = false);
     bool insertNonFull(T k, Visualizer& vis);
     bool remove(T k, Visualizer& vis);
     
     void rangeSearchInLeaf(T end, Visualizer& vis, bool& found_any);
 
-    void splitChild(int i, BPlusTreeNode* y, Visualizer& vis);
+    void splitChild(int i, BPlusTreeNode* y, Visualizer& vis, bool append = false);
+    bool isAppendSplit(BPlusTreeNode* y, T k);
     int findKey(T k);
     
     void removeFromLeaf(int idx, Visualizer& vis);
@@ -37,22 +45,148 @@ public:
     void borrowFromNext(int idx, Visualizer& vis);
     void merge(int idx, Visualizer& vis);
 
+    int dropTombstones();
+
+    // 키 배열(with_children면 자식 포인터 배열도)의 캐시 라인을 한꺼번에 미리 부른다.
+    // 두 배열은 노드와 따로 할당되어 있어서, 그냥 두면 노드 -> 키 -> 자식 순서로 miss가 이어진다.
+    void prefetchContents(bool with_children) const;
+
     bool is_leaf_node();
+    string keyLabel(int idx);
     void draw(Visualizer& vis);
 
     friend class BPlusTree<T>;
+    friend class LearnedBPlusTree<T>;
+    friend class LSMTree<T>;
 };
 
 template <typename T>
 class BPlusTree : public DataTree<T> {
     int t;
+
+    // Lazy delete: remove()는 리프 키에 tombstone만 표시하고,
+    // 재조정(fill/borrow/merge)은 compact()에서 한꺼번에 처리한다.
+    bool lazy_delete = false;
+    double compact_ratio = 0.25;
+    int live_count = 0;
+    int tombstone_count = 0;
+    // split()은 한 경로만 건드리므로 양쪽 키 수를 모른다. 필요할 때 리프 체인을 세어 채운다.
+    bool counts_stale = false;
+
+    // 가장 오른쪽 리프 힌트. 구조가 바뀌면 nullptr로 무효화하고 필요할 때 다시 찾는다.
+    BPlusTreeNode<T>* tail_leaf = nullptr;
+
+    // 있으면 search가 먼저 확인해 없는 키는 하강 없이 돌려보낸다. insert마다 채운다.
+    unique_ptr<BloomFilter<T>> bloom;
+    void rebuildBloom();
+    void bloomRemoved();
+
+    // 리프 체인을 몇 리프 앞서 미리 부를지. 0이면 하강 중 prefetch도 하지 않는다.
+    int prefetch_distance = 4;
+
+    // 스캔하는 리프보다 distance 리프 앞을 따라가며 그 리프의 노드와 키 배열을 미리 부른다.
+    // 체인을 따라가는 miss 자체는 남지만 앞선 리프들의 키 처리와 겹친다.
+    // 첫 리프에서 끝나는 짧은 스캔이 앞서 걷는 비용을 내지 않도록 리프를 넘길 때마다 두 칸씩 따라붙는다.
+    class LeafPrefetcher {
+        BPlusTreeNode<T>* ahead;
+        int lead = 0;  // ahead가 스캔 중인 리프보다 몇 리프 앞인지
+        int distance;
+
+    public:
+        LeafPrefetcher(BPlusTreeNode<T>* leaf, int distance) : ahead(leaf), distance(distance) {}
+        // 스캔이 다음 리프로 넘어갈 때마다 부른다.
+        void advance() {
+            if (lead > 0) lead--;
+            else if (ahead) ahead = ahead->next;
+            for (int step = 0; step < 2 && lead < distance && ahead && ahead->next; step++, lead++) {
+                ahead = ahead->next;
+                __builtin_prefetch(ahead);
+                __builtin_prefetch(reinterpret_cast<const char*>(ahead) + 64);
+                ahead->prefetchContents(false);
+            }
+        }
+    };
+
+    BPlusTreeNode<T>* findLeaf(T k);
+    BPlusTreeNode<T>* tailLeaf();
+    bool tryAppend(T k);
+    bool markTombstone(T k);
+    void rebuildFromSorted(const vector<T>& keys);
+    static void freeSubtree(BPlusTreeNode<T>* node);
+    void refreshCounts();
+
+    // split/concat 중간 결과. height는 리프가 1, 빈 트리가 0이다.
+    struct SubTree {
+        BPlusTreeNode<T>* root = nullptr;
+        int height = 0;
+    };
+
+    SubTree whole();
+    void adopt(SubTree s);
+    SubTree growIfFull(SubTree s);
+    SubTree joinAt(SubTree l, T sep, SubTree r);
+    void rebalancePair(BPlusTreeNode<T>* p, int i);
+    SubTree keyRange(BPlusTreeNode<T>* x, int from, int to, int height);
+    void splitAt(SubTree s, T key, SubTree& l, SubTree& r);
+    static BPlusTreeNode<T>* edgeLeaf(BPlusTreeNode<T>* node, bool last);
+
 public:
     BPlusTree(int _t);
+    ~BPlusTree();
 
     bool search(T k);
     bool insert(T k);
     bool remove(T k);
     bool rangeSearch(T begin, T end);
+
+    // [begin, end] 안의 살아 있는 키를 순서대로 f에 넘긴다. 하나라도 있었는지 반환. 시각화는 하지 않는다.
+    template <typename F>
+    bool rangeScan(T begin, T end, F f);
+
+    // keys를 group개씩 묶어 한 층씩 나란히 내려간다. 층마다 (키 배열 부르기 / 키 비교 후 자식 포인터 라인 부르기 /
+    // 자식 노드 부르기) 세 단계를 group개에 대해 차례로 돌려서 서로 독립인 miss가 한꺼번에 떠 있게 한다.
+    // 결과 i는 search(keys[i])와 같다. 시각화와 Bloom 필터는 거치지 않는다.
+    vector<bool> searchBatch(const vector<T>& keys, int group = 16);
+
+    // 리프 체인을 따라갈 때 몇 리프 앞까지 미리 부를지 정한다 (기본 4). 0이면 prefetch를 모두 끈다.
+    void setPrefetchDistance(int leaves) { prefetch_distance = max(leaves, 0); }
+    int getPrefetchDistance() const { return prefetch_distance; }
+
+    void setLazyDelete(bool enabled, double ratio = 0.25);
+    void compact();
+    int getTombstoneCount() {
+        refreshCounts();
+        return tombstone_count;
+    }
+
+    // search 앞에 블록 Bloom 필터를 둔다. capacity(0이면 현재 키 수의 두 배)를 넘게 차거나 지운 키가 많아지면
+    // 남은 키로 다시 만든다. 끄면 필터를 버린다.
+    void setBloomFilter(bool enabled, double fpr = 0.01, size_t capacity = 0);
+    BloomStats getBloomStats() const { return bloom ? bloom->getStats() : BloomStats{}; }
+    void resetBloomStats() {
+        if (bloom) bloom->resetStats();
+    }
+
+    // key 미만은 left로, key 이상은 right로 옮긴다. this는 비게 되고
+    // left/right는 기존 내용을 버리고 this의 차수와 lazy delete 설정을 따른다. key가 있었는지 반환.
+    bool split(T key, BPlusTree<T>& left, BPlusTree<T>& right);
+    // this의 모든 키 < right의 모든 키일 때 right를 뒤에 이어 붙이고 리프 체인도 잇는다. right는 비게 된다.
+    bool concat(BPlusTree<T>& right);
+    // [begin, end] 안의 키를 한꺼번에 지우고 지운 (살아 있던) 키 수를 반환한다.
+    // 양 끝 경로만 잘라 내고 그 사이 노드는 통째로 버리므로 O(log n + 지운 노드 수)다.
+    int removeRange(T begin, T end);
+
+    // 노드를 BFS 순서로 path에 쓴다. tombstone 키는 빠지고 리프 체인은 오프셋으로 남는다.
+    bool saveSnapshot(const string& path);
+
+    // 기존 내용을 버리고 중복 없이 오름차순인 keys로 리프부터 한 번에 쌓는다 (insert를 반복하는 것보다 훨씬 싸다).
+    void bulkLoad(const vector<T>& keys);
+
+protected:
+    optional<T> bound(T x, bool greater, bool inclusive) override;
+
+    friend class LearnedBPlusTree<T>;
+    friend class LSMTree<T>;
 };
 
 // ---------------- Implementation ----------------
@@ -65,6 +199,7 @@ BPlusTreeNode<T>::BPlusTreeNode(int _t, bool leaf) {
     this->key_count = 0;
     this->children_count = 0;
     this->next = nullptr;
+    this->tombstone.resize(2 * t, false);
 }
 
 template <typename T>
@@ -75,7 +210,18 @@ bool BPlusTreeNode<T>::is_leaf_node() {
 // ---------------- Search ----------------
 
 template <typename T>
-bool BPlusTreeNode<T>::search(T k, Visualizer& vis) {
+void BPlusTreeNode<T>::prefetchContents(bool with_children) const {
+    auto lines = [](const void* p, size_t bytes) {
+        const char* c = static_cast<const char*>(p);
+        for (size_t off = 0; off < bytes + (reinterpret_cast<uintptr_t>(c) & 63); off += 64) __builtin_prefetch(c + off);
+    };
+    lines(this->key.data(), sizeof(T) * max(this->key_count, 1));
+    if (with_children) lines(this->children.data(), sizeof(DataNode<T>*) * (this->key_count + 1));
+}
+
+template <typename T>
+bool BPlusTreeNode<T>::search(T k, Visualizer& vis, bool prefetch) {
+    if (prefetch) prefetchContents(true);
     int i = 0;
     vis.setMessage("Searching " + DataNode<T>::toString(k) + " in " + (is_leaf_node() ? "Leaf" : "Internal") + " Node");
     vis.setColor(this, Color::YELLOW);
@@ -88,6 +234,12 @@ bool BPlusTreeNode<T>::search(T k, Visualizer& vis) {
     if (is_leaf_node()) {
         for (int j = 0; j < this->key_count; j++) {
              vis.setColor(this, j, Color::YELLOW);
+             if (this->key[j] == k && this->tombstone[j]) {
+                 vis.setMessage("Key is marked as tombstone.");
+                 vis.setColor(this, j, Color::RED);
+                 vis.render();
+                 return false;
+             }
              if (this->key[j] == k) {
                  vis.setMessage("Key found in leaf node!");
                  vis.setColor(this, j, Color::GREEN);
@@ -106,14 +258,23 @@ bool BPlusTreeNode<T>::search(T k, Visualizer& vis) {
         vis.setMessage("Target " + DataNode<T>::toString(k) + " in range.\n-> Moving to child " + DataNode<int>::toString(i));
         vis.setColor(this, Color::RESET);
         vis.render();
-        return dynamic_cast<BPlusTreeNode<T>*>(this->children[i])->search(k, vis);
+        return dynamic_cast<BPlusTreeNode<T>*>(this->children[i])->search(k, vis, prefetch);
     }
 }
 
 // ---------------- Insert ----------------
 
+// 가장 오른쪽 리프에 그 리프의 최댓값보다 큰 키가 들어오면 (시간순 키 등)
+// 반씩 나누지 않고 마지막 키 하나만 새 리프로 옮긴다. 왼쪽 리프는 거의 가득 찬 채로
+// 남고 이후 키는 계속 새 리프에 쌓인다. 내부 노드는 merge()가 형제의 키 수를
+// t - 1로 가정하므로 항상 반씩 나눈다.
+template <typename T>
+bool BPlusTreeNode<T>::isAppendSplit(BPlusTreeNode<T>* y, T k) {
+    return y->is_leaf_node() && y->next == nullptr && k > y->key[y->key_count - 1];
+}
+
 template <typename T>
-void BPlusTreeNode<T>::splitChild(int i, BPlusTreeNode<T>* y, Visualizer& vis) {
+void BPlusTreeNode<T>::splitChild(int i, BPlusTreeNode<T>* y, Visualizer& vis, bool append) {
     vis.setMessage("Splitting " + string(y->is_leaf_node() ? "Leaf" : "Internal") + " child at index " + DataNode<int>::toString(i));
     vis.setColor(y, Color::RED);
     vis.render();
@@ -121,11 +282,15 @@ void BPlusTreeNode<T>::splitChild(int i, BPlusTreeNode<T>* y, Visualizer& vis) {
     BPlusTreeNode<T>* z = new BPlusTreeNode<T>(y->t, y->is_leaf_node());
     
     if (y->is_leaf_node()) {
-        z->key_count = t;
-        y->key_count = t - 1;
-
-        for (int j = 0; j < t; j++) {
-            z->key[j] = y->key[j + t - 1]; 
+        int move_count = append ? 1 : t;
+        int keep_count = y->key_count - move_count;
+        z->key_count = move_count;
+        y->key_count = keep_count;
+
+        for (int j = 0; j < move_count; j++) {
+            z->key[j] = y->key[j + keep_count]; 
+            z->tombstone[j] = y->tombstone[j + keep_count];
+            y->tombstone[j + keep_count] = false;
         }
         
         z->next = y->next;
@@ -203,9 +368,11 @@ bool BPlusTreeNode<T>::insertNonFull(T k, Visualizer& vis) {
 
         while (i >= 0 && this->key[i] > k) {
             this->key[i + 1] = this->key[i];
+            this->tombstone[i + 1] = this->tombstone[i];
             i--;
         }
         this->key[i + 1] = k;
+        this->tombstone[i + 1] = false;
         this->key_count++;
         
         vis.setColor(this, i + 1, Color::GREEN);
@@ -223,9 +390,10 @@ bool BPlusTreeNode<T>::insertNonFull(T k, Visualizer& vis) {
         BPlusTreeNode<T>* child = dynamic_cast<BPlusTreeNode<T>*>(this->children[i]);
         
         if (child->key_count == 2 * t - 1) {
-            vis.setMessage("Child is full. Splitting.");
+            bool append = isAppendSplit(child, k);
+            vis.setMessage(append ? "Right-most leaf is full. Splitting off the last key." : "Child is full. Splitting.");
             vis.render();
-            splitChild(i, child, vis);
+            splitChild(i, child, vis, append);
             
             if (this->key[i] < k) {
                 i++;
@@ -293,9 +461,12 @@ void BPlusTreeNode<T>::removeFromLeaf(int idx, Visualizer& vis) {
     vis.setColor(this, idx, Color::MAGENTA);
     vis.render();
 
-    for (int i = idx + 1; i < this->key_count; ++i)
+    for (int i = idx + 1; i < this->key_count; ++i) {
         this->key[i - 1] = this->key[i];
+        this->tombstone[i - 1] = this->tombstone[i];
+    }
     this->key_count--;
+    this->tombstone[this->key_count] = false;
     
     vis.setColor(this, Color::RESET);
 }
@@ -322,8 +493,10 @@ void BPlusTreeNode<T>::borrowFromPrev(int idx, Visualizer& vis) {
     BPlusTreeNode<T>* child = dynamic_cast<BPlusTreeNode<T>*>(this->children[idx]);
     BPlusTreeNode<T>* sibling = dynamic_cast<BPlusTreeNode<T>*>(this->children[idx - 1]);
 
-    for (int i = child->key_count - 1; i >= 0; --i)
+    for (int i = child->key_count - 1; i >= 0; --i) {
         child->key[i + 1] = child->key[i];
+        child->tombstone[i + 1] = child->tombstone[i];
+    }
     if (!child->is_leaf_node()) {
         for (int i = child->children_count - 1; i >= 0; --i)
             child->children[i + 1] = child->children[i];
@@ -331,6 +504,8 @@ void BPlusTreeNode<T>::borrowFromPrev(int idx, Visualizer& vis) {
 
     if (child->is_leaf_node()) {
         child->key[0] = sibling->key[sibling->key_count - 1];
+        child->tombstone[0] = sibling->tombstone[sibling->key_count - 1];
+        sibling->tombstone[sibling->key_count - 1] = false;
         this->key[idx - 1] = child->key[0];
     } else {
         child->key[0] = this->key[idx - 1];
@@ -358,9 +533,13 @@ void BPlusTreeNode<T>::borrowFromNext(int idx, Visualizer& vis) {
 
     if (child->is_leaf_node()) {
         child->key[child->key_count] = sibling->key[0];
+        child->tombstone[child->key_count] = sibling->tombstone[0];
         
-        for (int i = 1; i < sibling->key_count; ++i)
+        for (int i = 1; i < sibling->key_count; ++i) {
             sibling->key[i - 1] = sibling->key[i];
+            sibling->tombstone[i - 1] = sibling->tombstone[i];
+        }
+        sibling->tombstone[sibling->key_count - 1] = false;
             
         this->key[idx] = sibling->key[0];
     } else {
@@ -393,8 +572,10 @@ void BPlusTreeNode<T>::merge(int idx, Visualizer& vis) {
     BPlusTreeNode<T>* sibling = dynamic_cast<BPlusTreeNode<T>*>(this->children[idx + 1]);
 
     if (child->is_leaf_node()) {
-        for (int i = 0; i < sibling->key_count; ++i)
+        for (int i = 0; i < sibling->key_count; ++i) {
             child->key[i + child->key_count] = sibling->key[i];
+            child->tombstone[i + child->key_count] = sibling->tombstone[i];
+        }
         child->key_count += sibling->key_count;
         
         child->next = sibling->next;
@@ -442,6 +623,7 @@ void BPlusTreeNode<T>::rangeSearchInLeaf(T end, Visualizer& vis, bool& found_any
                 stop = true;
                 break;
             }
+            if (current->tombstone[i]) continue;
             vis.setColor(current, i, Color::GREEN);
             vis.setMessage("Key " + DataNode<T>::toString(k) + " in range!");
             found_any = true;
@@ -466,8 +648,34 @@ void BPlusTreeNode<T>::rangeSearchInLeaf(T end, Visualizer& vis, bool& found_any
     }
 }
 
+// ---------------- Tombstone ----------------
+
+template <typename T>
+int BPlusTreeNode<T>::dropTombstones() {
+    int w = 0;
+    for (int r = 0; r < this->key_count; r++) {
+        if (this->tombstone[r]) continue;
+        this->key[w] = this->key[r];
+        this->tombstone[w] = false;
+        w++;
+    }
+    for (int r = w; r < this->key_count; r++)
+        this->tombstone[r] = false;
+
+    int dropped = this->key_count - w;
+    this->key_count = w;
+    return dropped;
+}
+
 // ---------------- Draw ----------------
 
+template <typename T>
+string BPlusTreeNode<T>::keyLabel(int idx) {
+    if (this->tombstone[idx])
+        return DataNode<T>::toString(this->key[idx]) + " (deleted)";
+    return DataNode<T>::toString(this->key[idx]);
+}
+
 template <typename T>
 void BPlusTreeNode<T>::draw(Visualizer& vis) {
     int n = this->key_count;
@@ -475,9 +683,9 @@ void BPlusTreeNode<T>::draw(Visualizer& vis) {
     
     if (this->is_leaf_node()) {
         for(int i = n-1; i >=0; --i) {
-            if (i == mid) vis.printKey(Pos::MID_NORM, DataNode<T>::toString(this->key[i]), this, i);
-            else if (i > mid) vis.printKey(Pos::UP, DataNode<T>::toString(this->key[i]), this, i);
-            else vis.printKey(Pos::DOWN, DataNode<T>::toString(this->key[i]), this, i);
+            if (i == mid) vis.printKey(Pos::MID_NORM, keyLabel(i), this, i);
+            else if (i > mid) vis.printKey(Pos::UP, keyLabel(i), this, i);
+            else vis.printKey(Pos::DOWN, keyLabel(i), this, i);
         }
         return;
     }
@@ -519,6 +727,11 @@ void BPlusTreeNode<T>::draw(Visualizer& vis) {
 template <typename T>
 BPlusTree<T>::BPlusTree(int _t) : t(_t) {}
 
+template <typename T>
+BPlusTree<T>::~BPlusTree() {
+    freeSubtree(dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr));
+}
+
 template <typename T>
 bool BPlusTree<T>::search(T k) {
     this->vis->clear();
@@ -528,13 +741,45 @@ bool BPlusTree<T>::search(T k) {
         this->vis->render();
         return false;
     }
-    return dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr)->search(k, *(this->vis));
+    if (bloom && !bloom->mayContain(k)) {
+        this->vis->setMessage("Bloom filter: key is definitely absent.");
+        this->vis->render();
+        return false;
+    }
+    bool found = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr)->search(k, *(this->vis), prefetch_distance > 0);
+    if (bloom && !found) bloom->noteFalsePositive();
+    return found;
 }
 
 template <typename T>
 bool BPlusTree<T>::insert(T k) {
     this->vis->clear();
     this->vis->setTitle("Inserting: " + DataNode<T>::toString(k));
+
+    // 이미 있는 키를 다시 넣어도 같은 비트라 상관없으므로 먼저 넣어 둔다.
+    if (bloom) {
+        if (bloom->needsRebuild()) rebuildBloom();
+        bloom->add(k);
+    }
+
+    if (tryAppend(k)) return true;
+    tail_leaf = nullptr;
+
+    refreshCounts();
+    if (this->root_ptr != nullptr && tombstone_count > 0) {
+        BPlusTreeNode<T>* leaf = findLeaf(k);
+        int idx = leaf->findKey(k);
+        if (idx < leaf->key_count && leaf->key[idx] == k && leaf->tombstone[idx]) {
+            leaf->tombstone[idx] = false;
+            tombstone_count--;
+            live_count++;
+
+            this->vis->setMessage("Reviving tombstoned key " + DataNode<T>::toString(k) + ".");
+            this->vis->setColor(leaf, idx, Color::GREEN);
+            this->vis->render();
+            return true;
+        }
+    }
     
     if (this->root_ptr == nullptr) {
         this->vis->setMessage("Empty Tree. Creating Root Leaf.");
@@ -544,12 +789,14 @@ bool BPlusTree<T>::insert(T k) {
         root->key[0] = k;
         root->key_count = 1;
         this->setRoot(root);
+        live_count++;
         
         this->vis->setColor(this->root_ptr, 0, Color::GREEN);
         this->vis->render();
         return true;
     } else {
         BPlusTreeNode<T>* r = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
+        bool inserted;
         if (r->key_count == 2 * t - 1) {
             this->vis->setMessage("Root is full. Splitting.");
             this->vis->render();
@@ -558,16 +805,18 @@ bool BPlusTree<T>::insert(T k) {
             s->children[0] = r;
             s->children_count = 1;
             
-            s->splitChild(0, r, *(this->vis));
+            s->splitChild(0, r, *(this->vis), s->isAppendSplit(r, k));
             this->setRoot(s);
             
             int i = 0;
-            if (s->key[0] < k) i++;
+            if (s->key[0] <= k) i++;
             
-            return dynamic_cast<BPlusTreeNode<T>*>(s->children[i])->insertNonFull(k, *(this->vis));
+            inserted = dynamic_cast<BPlusTreeNode<T>*>(s->children[i])->insertNonFull(k, *(this->vis));
         } else {
-            return r->insertNonFull(k, *(this->vis));
+            inserted = r->insertNonFull(k, *(this->vis));
         }
+        if (inserted) live_count++;
+        return inserted;
     }
 }
 
@@ -581,8 +830,20 @@ bool BPlusTree<T>::remove(T k) {
         return false;
     }
     
+    tail_leaf = nullptr;
+
+    if (lazy_delete) {
+        bool marked = markTombstone(k);
+        if (marked && bloom) bloomRemoved();
+        this->vis->setMessage(marked ? "Removal Complete." : "Key not found.");
+        this->vis->render();
+        return marked;
+    }
+    
     BPlusTreeNode<T>* root = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
     bool result = root->remove(k, *(this->vis));
+    if (result) live_count--;
+    if (result && bloom) bloomRemoved();
     
     if (root->key_count == 0 && !root->is_leaf_node()) {
         this->vis->setMessage("Root is empty. Shrinking height.");
@@ -611,15 +872,11 @@ bool BPlusTree<T>::rangeSearch(T begin, T end) {
     this->vis->setMessage("Locating starting Leaf Node for " + DataNode<T>::toString(begin));
     this->vis->render();
     
-    BPlusTreeNode<T>* curr = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
-    while (!curr->is_leaf_node()) {
-        int i = 0;
-        while (i < curr->key_count && begin >= curr->key[i]) i++;
-        curr = dynamic_cast<BPlusTreeNode<T>*>(curr->children[i]);
-    }
+    BPlusTreeNode<T>* curr = findLeaf(begin);
     
     bool found_any = false;
     BPlusTreeNode<T>* leaf = curr;
+    LeafPrefetcher ahead(leaf, prefetch_distance);
     while (leaf != nullptr) {
         bool stop = false;
         this->vis->setColor(leaf, Color::YELLOW);
@@ -631,7 +888,7 @@ bool BPlusTree<T>::rangeSearch(T begin, T end) {
                 stop = true; 
                 break;
             }
-            if (k >= begin) {
+            if (k >= begin && !leaf->tombstone[i]) {
                 this->vis->setColor(leaf, i, Color::GREEN);
                 this->vis->setMessage("Found " + DataNode<T>::toString(k));
                 found_any = true;
@@ -641,6 +898,7 @@ bool BPlusTree<T>::rangeSearch(T begin, T end) {
         
         if (stop) break;
         leaf = leaf->next;
+        ahead.advance();
         if (leaf) {
             this->vis->setMessage("Following Linked List ->");
             this->vis->render();
@@ -651,4 +909,791 @@ bool BPlusTree<T>::rangeSearch(T begin, T end) {
     this->vis->setMessage(found_any ? "Range Search Done." : "No keys in range.");
     this->vis->render();
     return found_any;
-}
\ No newline at end of file
+}
+
+// ---------------- Bound (Successor / Predecessor) ----------------
+
+// x가 들어갈 리프에서 시작한다. 큰 쪽은 리프 체인(next)을 따라가고,
+// 리프 체인은 오른쪽으로만 이어지므로 작은 쪽은 내려온 경로를 되짚어 왼쪽 리프로 간다.
+// tombstone 키는 건너뛴다.
+template <typename T>
+optional<T> BPlusTree<T>::bound(T x, bool greater, bool inclusive) {
+    this->vis->clear();
+    this->vis->setTitle(this->boundTitle(greater, inclusive) + " of: " + DataNode<T>::toString(x));
+    if (!this->root_ptr) return nullopt;
+
+    vector<pair<BPlusTreeNode<T>*, int>> path;
+    BPlusTreeNode<T>* leaf = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
+    while (!leaf->is_leaf_node()) {
+        this->stats.visited++;
+        int i = 0;
+        while (i < leaf->key_count && x >= leaf->key[i]) i++;
+        path.push_back({leaf, i});
+        leaf = dynamic_cast<BPlusTreeNode<T>*>(leaf->children[i]);
+    }
+
+    while (leaf != nullptr) {
+        this->stats.visited++;
+        this->vis->setColor(leaf, Color::YELLOW);
+        this->vis->render();
+
+        int n = leaf->key_count;
+        for (int j = 0; j < n; j++) {
+            int idx = greater ? j : n - 1 - j;
+            T k = leaf->key[idx];
+            if (leaf->tombstone[idx]) continue;
+            if ((inclusive && k == x) || (greater ? k > x : k < x)) {
+                this->vis->setColor(leaf, idx, Color::GREEN);
+                this->vis->setMessage("Result: " + DataNode<T>::toString(k));
+                this->vis->render();
+                return k;
+            }
+        }
+        this->vis->setColor(leaf, Color::RESET);
+
+        if (greater) {
+            this->vis->setMessage("Following Linked List ->");
+            leaf = leaf->next;
+        } else {
+            this->vis->setMessage("<- Backtracking to the previous leaf");
+            while (!path.empty() && path.back().second == 0) path.pop_back();
+            if (path.empty()) break;
+            BPlusTreeNode<T>* node = path.back().first;
+            int i = --path.back().second;
+            leaf = dynamic_cast<BPlusTreeNode<T>*>(node->children[i]);
+            while (!leaf->is_leaf_node()) {
+                path.push_back({leaf, leaf->key_count});
+                leaf = dynamic_cast<BPlusTreeNode<T>*>(leaf->children[leaf->key_count]);
+            }
+        }
+        this->vis->render();
+    }
+
+    this->vis->setMessage("No such key.");
+    this->vis->render();
+    return nullopt;
+}
+
+// ---------------- Append Fast Path ----------------
+
+template <typename T>
+BPlusTreeNode<T>* BPlusTree<T>::tailLeaf() {
+    if (tail_leaf == nullptr && this->root_ptr != nullptr) {
+        BPlusTreeNode<T>* curr = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
+        while (!curr->is_leaf_node())
+            curr = dynamic_cast<BPlusTreeNode<T>*>(curr->children[curr->key_count]);
+        tail_leaf = curr;
+    }
+    return tail_leaf;
+}
+
+// 현재 최댓값보다 큰 키는 가장 오른쪽 리프에만 들어갈 수 있으므로, 그 리프에
+// 자리가 있으면 루트부터 내려가지 않고 바로 붙인다. 리프가 가득 차서 분할이
+// 필요할 때만 insert()의 일반 경로가 경로를 다시 내려간다.
+template <typename T>
+bool BPlusTree<T>::tryAppend(T k) {
+    BPlusTreeNode<T>* leaf = tailLeaf();
+    if (leaf == nullptr || leaf->key_count == 0 || leaf->key_count == 2 * t - 1) return false;
+    if (!(k > leaf->key[leaf->key_count - 1])) return false;
+
+    leaf->key[leaf->key_count] = k;
+    leaf->tombstone[leaf->key_count] = false;
+    leaf->key_count++;
+    live_count++;
+
+    this->vis->setMessage("Key is larger than the current maximum.\nAppending to the right-most leaf directly.");
+    this->vis->setColor(leaf, leaf->key_count - 1, Color::GREEN);
+    this->vis->render();
+    return true;
+}
+
+// ---------------- Lazy Delete ----------------
+
+template <typename T>
+void BPlusTree<T>::setLazyDelete(bool enabled, double ratio) {
+    compact_ratio = ratio;
+    refreshCounts();
+    if (lazy_delete && !enabled && tombstone_count > 0) {
+        lazy_delete = false;
+        compact();
+    }
+    lazy_delete = enabled;
+}
+
+template <typename T>
+BPlusTreeNode<T>* BPlusTree<T>::findLeaf(T k) {
+    BPlusTreeNode<T>* curr = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
+    bool prefetch = prefetch_distance > 0;
+    if (prefetch) curr->prefetchContents(true);
+    while (!curr->is_leaf_node()) {
+        int i = 0;
+        while (i < curr->key_count && k >= curr->key[i]) i++;
+        curr = dynamic_cast<BPlusTreeNode<T>*>(curr->children[i]);
+        if (prefetch) curr->prefetchContents(true);
+    }
+    return curr;
+}
+
+// 리프는 모두 같은 깊이이므로 height - 1번 내려가면 모든 키가 리프에 닿는다.
+// dynamic_cast는 자식 객체를 바로 읽어서 미리 부른 의미가 없어지므로 여기서는 static_cast로 내려간다.
+template <typename T>
+vector<bool> BPlusTree<T>::searchBatch(const vector<T>& keys, int group) {
+    vector<bool> found(keys.size(), false);
+    if (!this->root_ptr) return found;
+    refreshCounts();
+    bool check_tombstones = tombstone_count > 0;
+    group = max(group, 1);
+    int height = whole().height;
+    BPlusTreeNode<T>* root = static_cast<BPlusTreeNode<T>*>(this->root_ptr);
+    vector<BPlusTreeNode<T>*> at(group);
+    vector<int> slot(group);
+
+    for (size_t base = 0; base < keys.size(); base += group) {
+        int g = int(min<size_t>(group, keys.size() - base));
+        for (int j = 0; j < g; j++) at[j] = root;
+        for (int level = 1; level < height; level++) {
+            for (int j = 0; j < g; j++) at[j]->prefetchContents(false);
+            for (int j = 0; j < g; j++) {
+                BPlusTreeNode<T>* x = at[j];
+                const T& k = keys[base + j];
+                int i = 0;
+                while (i < x->key_count && k >= x->key[i]) i++;
+                slot[j] = i;
+                __builtin_prefetch(&x->children[i]);
+            }
+            for (int j = 0; j < g; j++) {
+                at[j] = static_cast<BPlusTreeNode<T>*>(at[j]->children[slot[j]]);
+                __builtin_prefetch(at[j]);
+                __builtin_prefetch(reinterpret_cast<const char*>(at[j]) + 64);
+            }
+        }
+        for (int j = 0; j < g; j++) at[j]->prefetchContents(false);
+        for (int j = 0; j < g; j++) {
+            BPlusTreeNode<T>* leaf = at[j];
+            const T& k = keys[base + j];
+            int idx = leaf->findKey(k);
+            found[base + j] = idx < leaf->key_count && leaf->key[idx] == k && !(check_tombstones && leaf->tombstone[idx]);
+        }
+    }
+    return found;
+}
+
+template <typename T>
+template <typename F>
+bool BPlusTree<T>::rangeScan(T begin, T end, F f) {
+    if (!this->root_ptr) return false;
+    refreshCounts();
+    bool check_tombstones = tombstone_count > 0;
+
+    BPlusTreeNode<T>* leaf = findLeaf(begin);
+    LeafPrefetcher ahead(leaf, prefetch_distance);
+    bool found_any = false;
+    for (int i = leaf->findKey(begin); leaf != nullptr; leaf = leaf->next, i = 0, ahead.advance()) {
+        for (; i < leaf->key_count; i++) {
+            T k = leaf->key[i];
+            if (end < k) return found_any;
+            if (check_tombstones && leaf->tombstone[i]) continue;
+            f(k);
+            found_any = true;
+        }
+    }
+    return found_any;
+}
+
+template <typename T>
+bool BPlusTree<T>::markTombstone(T k) {
+    BPlusTreeNode<T>* leaf = findLeaf(k);
+    int idx = leaf->findKey(k);
+
+    this->vis->setMessage("Locating leaf for " + DataNode<T>::toString(k));
+    this->vis->setColor(leaf, Color::YELLOW);
+    this->vis->render();
+
+    if (idx >= leaf->key_count || leaf->key[idx] != k || leaf->tombstone[idx]) {
+        this->vis->setMessage("Key not found in leaf.");
+        this->vis->setColor(leaf, Color::RED);
+        this->vis->render();
+        return false;
+    }
+
+    leaf->tombstone[idx] = true;
+    tombstone_count++;
+    live_count--;
+
+    this->vis->setMessage("Marked " + DataNode<T>::toString(k) + " as tombstone.");
+    this->vis->setColor(leaf, Color::RESET);
+    this->vis->setColor(leaf, idx, Color::MAGENTA);
+    this->vis->render();
+
+    refreshCounts();
+    if (tombstone_count > compact_ratio * (live_count + tombstone_count))
+        compact();
+    return true;
+}
+
+// 모든 리프에서 tombstone을 걷어낸 뒤, 최소 키 수를 밑도는 리프가 생기면
+// 리프 체인의 살아있는 키로 트리를 한 번에 다시 쌓는다.
+template <typename T>
+void BPlusTree<T>::compact() {
+    refreshCounts();
+    this->vis->clear();
+    this->vis->setTitle("Compacting " + DataNode<int>::toString(tombstone_count) + " tombstone(s)");
+
+    if (this->root_ptr == nullptr || tombstone_count == 0) {
+        this->vis->setMessage("Nothing to compact.");
+        this->vis->render();
+        return;
+    }
+
+    BPlusTreeNode<T>* root = dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr);
+    BPlusTreeNode<T>* leaf = root;
+    while (!leaf->is_leaf_node())
+        leaf = dynamic_cast<BPlusTreeNode<T>*>(leaf->children[0]);
+    BPlusTreeNode<T>* first_leaf = leaf;
+
+    // 가장 오른쪽 리프는 append split으로 원래 적게 차 있을 수 있으므로 비었을 때만 본다.
+    bool underflow = false;
+    for (; leaf != nullptr; leaf = leaf->next) {
+        leaf->dropTombstones();
+        if (leaf == root) continue;
+        if (leaf->key_count == 0 || (leaf->next != nullptr && leaf->key_count < t - 1)) underflow = true;
+    }
+    tombstone_count = 0;
+
+    if (root->is_leaf_node() && root->key_count == 0) {
+        this->setRoot(nullptr);
+        tail_leaf = nullptr;
+        delete root;
+    } else if (underflow) {
+        this->vis->setMessage("Some leaves underflowed. Rebuilding from the leaf chain.");
+        this->vis->render();
+
+        vector<T> keys;
+        keys.reserve(live_count);
+        for (leaf = first_leaf; leaf != nullptr; leaf = leaf->next)
+            for (int i = 0; i < leaf->key_count; i++)
+                keys.push_back(leaf->key[i]);
+        rebuildFromSorted(keys);
+    }
+
+    this->vis->setMessage("Compaction Complete.");
+    this->vis->render();
+}
+
+template <typename T>
+void BPlusTree<T>::bulkLoad(const vector<T>& keys) {
+    rebuildFromSorted(keys);
+    live_count = keys.size();
+    tombstone_count = 0;
+    counts_stale = false;
+    if (bloom) rebuildBloom();
+}
+
+// 정렬된 키로 리프를 고르게 채우고, 각 레벨의 최소 키를 구분자로 올려 부모를 쌓는다.
+template <typename T>
+void BPlusTree<T>::rebuildFromSorted(const vector<T>& keys) {
+    freeSubtree(dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr));
+    this->setRoot(nullptr);
+    tail_leaf = nullptr;
+    if (keys.empty()) return;
+
+    int n = keys.size();
+    int leaf_count = (n + 2 * t - 2) / (2 * t - 1);
+    vector<BPlusTreeNode<T>*> level;
+    vector<T> mins;
+
+    BPlusTreeNode<T>* prev = nullptr;
+    for (int i = 0, pos = 0; i < leaf_count; i++) {
+        int take = n / leaf_count + (i < n % leaf_count ? 1 : 0);
+        BPlusTreeNode<T>* node = new BPlusTreeNode<T>(t, true);
+        for (int j = 0; j < take; j++)
+            node->key[j] = keys[pos + j];
+        node->key_count = take;
+        mins.push_back(keys[pos]);
+        pos += take;
+
+        if (prev) prev->next = node;
+        prev = node;
+        level.push_back(node);
+    }
+
+    while (level.size() > 1) {
+        int m = level.size();
+        int groups = (m + 2 * t - 1) / (2 * t);
+        vector<BPlusTreeNode<T>*> parents;
+        vector<T> parent_mins;
+
+        for (int g = 0, pos = 0; g < groups; g++) {
+            int take = m / groups + (g < m % groups ? 1 : 0);
+            BPlusTreeNode<T>* node = new BPlusTreeNode<T>(t, false);
+            for (int j = 0; j < take; j++) {
+                node->children[j] = level[pos + j];
+                if (j > 0) node->key[j - 1] = mins[pos + j];
+            }
+            node->children_count = take;
+            node->key_count = take - 1;
+            parent_mins.push_back(mins[pos]);
+            pos += take;
+            parents.push_back(node);
+        }
+        level.swap(parents);
+        mins.swap(parent_mins);
+    }
+    this->setRoot(level[0]);
+}
+
+template <typename T>
+void BPlusTree<T>::freeSubtree(BPlusTreeNode<T>* node) {
+    if (node == nullptr) return;
+    if (!node->is_leaf_node()) {
+        for (int i = 0; i <= node->key_count; i++)
+            freeSubtree(dynamic_cast<BPlusTreeNode<T>*>(node->children[i]));
+    }
+    delete node;
+}
+
+template <typename T>
+void BPlusTree<T>::refreshCounts() {
+    if (!counts_stale) return;
+    live_count = tombstone_count = 0;
+    if (this->root_ptr) {
+        for (BPlusTreeNode<T>* leaf = edgeLeaf(dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr), false); leaf; leaf = leaf->next)
+            for (int i = 0; i < leaf->key_count; i++)
+                (leaf->tombstone[i] ? tombstone_count : live_count)++;
+    }
+    counts_stale = false;
+}
+
+// ---------------- Bloom Filter ----------------
+
+template <typename T>
+void BPlusTree<T>::setBloomFilter(bool enabled, double fpr, size_t capacity) {
+    bloom.reset();
+    if (!enabled) return;
+    bloom.reset(new BloomFilter<T>(capacity, fpr));
+    rebuildBloom();
+}
+
+// 리프 체인의 살아있는 키로 다시 채운다.
+template <typename T>
+void BPlusTree<T>::rebuildBloom() {
+    vector<T> keys;
+    if (this->root_ptr) {
+        for (BPlusTreeNode<T>* leaf = edgeLeaf(dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr), false); leaf; leaf = leaf->next)
+            for (int i = 0; i < leaf->key_count; i++)
+                if (!leaf->tombstone[i]) keys.push_back(leaf->key[i]);
+    }
+    bloom->rebuild(keys);
+}
+
+template <typename T>
+void BPlusTree<T>::bloomRemoved() {
+    bloom->noteRemoved();
+    if (bloom->needsRebuild()) rebuildBloom();
+}
+
+// ---------------- Split / Concat ----------------
+// 루트에서 key까지 한 경로만 내려가며 각 노드를 key 왼쪽/오른쪽 조각으로 자르고,
+// 올라오면서 조각들을 joinAt(L, sep, R)으로 다시 붙인다. 리프 체인은 원래 순서를
+// 그대로 쓰므로 끊어지는 곳은 왼쪽 결과의 마지막 리프 한 곳뿐이다.
+
+template <typename T>
+bool BPlusTree<T>::split(T key, BPlusTree<T>& left, BPlusTree<T>& right) {
+    this->vis->clear();
+    this->vis->setTitle("Splitting at: " + DataNode<T>::toString(key));
+
+    bool found = false;
+    if (this->root_ptr) {
+        BPlusTreeNode<T>* leaf = findLeaf(key);
+        int idx = leaf->findKey(key);
+        found = idx < leaf->key_count && leaf->key[idx] == key && !leaf->tombstone[idx];
+    }
+
+    SubTree all = whole();
+    this->setRoot(nullptr);
+    tail_leaf = nullptr;
+    live_count = tombstone_count = 0;
+    counts_stale = false;
+
+    for (BPlusTree<T>* side : {&left, &right}) {
+        freeSubtree(dynamic_cast<BPlusTreeNode<T>*>(side->root_ptr));
+        side->setRoot(nullptr);
+        side->t = t;
+        side->lazy_delete = lazy_delete;
+        side->compact_ratio = compact_ratio;
+        side->bloom.reset();
+        if (bloom) side->bloom.reset(new BloomFilter<T>(0, bloom->targetFpr()));
+    }
+
+    SubTree l, r;
+    if (all.root) {
+        splitAt(all, key, l, r);
+        if (l.root) edgeLeaf(l.root, true)->next = nullptr;
+    }
+
+    left.adopt(l);
+    right.adopt(r);
+    if (bloom) {
+        rebuildBloom();
+        left.rebuildBloom();
+        right.rebuildBloom();
+    }
+
+    this->vis->setMessage("Split Complete.");
+    this->vis->render();
+    return found;
+}
+
+template <typename T>
+bool BPlusTree<T>::concat(BPlusTree<T>& right) {
+    this->vis->clear();
+    this->vis->setTitle("Concatenating two trees");
+
+    if (&right == this || right.t != t) return false;
+    SubTree l = whole(), r = right.whole();
+    if (r.root == nullptr) return true;
+
+    BPlusTreeNode<T>* last = l.root ? edgeLeaf(l.root, true) : nullptr;
+    BPlusTreeNode<T>* first = edgeLeaf(r.root, false);
+    if (last && !(last->key[last->key_count - 1] < first->key[0])) {
+        this->vis->setMessage("Keys overlap. Concat failed.");
+        this->vis->render();
+        return false;
+    }
+
+    // 한쪽이라도 키 수를 모르면 합친 트리도 나중에 센다.
+    bool stale = counts_stale || right.counts_stale;
+    int live = live_count + right.live_count;
+    int tomb = tombstone_count + right.tombstone_count;
+    if (last) {
+        last->next = first;
+        l = joinAt(l, first->key[0], r);
+    } else {
+        l = r;
+    }
+
+    right.adopt(SubTree{});
+    adopt(l);
+    live_count = live;
+    tombstone_count = tomb;
+    counts_stale = stale;
+    if (bloom) rebuildBloom();
+    if (right.bloom) right.rebuildBloom();
+
+    this->vis->setMessage("Concat Complete.");
+    this->vis->render();
+    return true;
+}
+
+// begin 앞과 end 뒤에서 한 번씩 splitAt으로 잘라 가운데 조각을 떼어 낸다. 자르는 경로의 노드만
+// 다시 만들고 가운데 리프는 next 체인을 따라 세기만 한 뒤 통째로 해제한다. 남은 양쪽은 joinAt으로 붙인다.
+// 가운데 조각의 마지막 리프 next는 잘린 뒤라 믿을 수 없으므로 체인은 그 리프까지만 따라간다.
+template <typename T>
+int BPlusTree<T>::removeRange(T begin, T end) {
+    this->vis->clear();
+    this->vis->setTitle("Removing range [" + DataNode<T>::toString(begin) + ", " + DataNode<T>::toString(end) + "]");
+    if (this->root_ptr == nullptr || end < begin) {
+        this->vis->setMessage("Nothing to remove.");
+        this->vis->render();
+        return 0;
+    }
+
+    // end 뒤의 첫 키 (tombstone이어도 된다). 오른쪽 조각을 여기서 자른다.
+    optional<T> after;
+    for (BPlusTreeNode<T>* leaf = findLeaf(end); leaf != nullptr && !after; leaf = leaf->next) {
+        int i = 0;
+        while (i < leaf->key_count && !(end < leaf->key[i])) i++;
+        if (i < leaf->key_count) after = leaf->key[i];
+    }
+
+    SubTree l, mid, r;
+    splitAt(whole(), begin, l, mid);
+    if (mid.root && after) {
+        SubTree rest = mid;
+        splitAt(rest, *after, mid, r);
+    }
+
+    int removed_live = 0, removed_tomb = 0;
+    if (mid.root) {
+        BPlusTreeNode<T>* last = edgeLeaf(mid.root, true);
+        for (BPlusTreeNode<T>* leaf = edgeLeaf(mid.root, false);; leaf = leaf->next) {
+            for (int i = 0; i < leaf->key_count; i++)
+                (leaf->tombstone[i] ? removed_tomb : removed_live)++;
+            if (leaf == last) break;
+        }
+        freeSubtree(mid.root);
+    }
+
+    if (l.root) {
+        BPlusTreeNode<T>* first = r.root ? edgeLeaf(r.root, false) : nullptr;
+        edgeLeaf(l.root, true)->next = first;
+        if (first) l = joinAt(l, first->key[0], r);
+    } else {
+        l = r;
+    }
+
+    bool stale = counts_stale;
+    int live = live_count - removed_live, tomb = tombstone_count - removed_tomb;
+    adopt(l);
+    if (!stale && l.root) {
+        live_count = live;
+        tombstone_count = tomb;
+        counts_stale = false;
+    }
+    if (bloom && removed_live > 0) {
+        for (int i = 0; i < removed_live; i++) bloom->noteRemoved();
+        if (bloom->needsRebuild()) rebuildBloom();
+    }
+
+    this->vis->setMessage("Removed " + to_string(removed_live) + " keys.");
+    this->vis->render();
+    return removed_live;
+}
+
+// 리프는 모두 같은 깊이라 BFS 마지막 층에 왼쪽부터 놓인다. 그래서 next 리프는 바로 다음 레코드다.
+template <typename T>
+bool BPlusTree<T>::saveSnapshot(const string& path) {
+    this->vis->clear();
+    this->vis->setTitle("Saving snapshot: " + path);
+
+    SnapshotWriter out(path, SnapshotKind::BPLUSTREE, sizeof(T), t, bnodeRecordSize(t, sizeof(T)));
+    vector<BPlusTreeNode<T>*> queue;
+    if (this->root_ptr) queue.push_back(dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr));
+
+    for (size_t i = 0; i < queue.size() && out.ok(); i++) {
+        BPlusTreeNode<T>* x = queue[i];
+        bool leaf = x->is_leaf_node();
+        out.begin();
+        out.put<uint32_t>(4, leaf);
+
+        uint32_t count = 0;
+        if (leaf) {
+            if (x->next) out.put<uint64_t>(8, out.offsetOf(i + 1));
+            for (int j = 0; j < x->key_count; j++)
+                if (!x->tombstone[j]) out.put<T>(bnodeKeysAt(t) + sizeof(T) * count++, x->key[j]);
+        } else {
+            for (int j = 0; j <= x->key_count; j++) {
+                out.put<uint64_t>(BNODE_CHILDREN_AT + 8 * j, out.offsetOf(queue.size()));
+                queue.push_back(dynamic_cast<BPlusTreeNode<T>*>(x->children[j]));
+            }
+            for (int j = 0; j < x->key_count; j++)
+                out.put<T>(bnodeKeysAt(t) + sizeof(T) * j, x->key[j]);
+            count = x->key_count;
+        }
+        out.put<uint32_t>(0, count);
+        out.commit(leaf ? count : 0);
+    }
+
+    bool ok = out.finish();
+    this->vis->setMessage(ok ? "Snapshot saved (" + to_string(queue.size()) + " nodes)." : "Failed to write snapshot.");
+    this->vis->render();
+    return ok;
+}
+
+template <typename T>
+typename BPlusTree<T>::SubTree BPlusTree<T>::whole() {
+    SubTree s{dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr), 0};
+    for (BPlusTreeNode<T>* x = s.root; x != nullptr; x = dynamic_cast<BPlusTreeNode<T>*>(x->children[0]))
+        s.height++;
+    return s;
+}
+
+template <typename T>
+void BPlusTree<T>::adopt(SubTree s) {
+    this->setRoot(s.root);
+    tail_leaf = nullptr;
+    live_count = tombstone_count = 0;
+    counts_stale = s.root != nullptr;
+}
+
+template <typename T>
+BPlusTreeNode<T>* BPlusTree<T>::edgeLeaf(BPlusTreeNode<T>* node, bool last) {
+    while (!node->is_leaf_node())
+        node = dynamic_cast<BPlusTreeNode<T>*>(node->children[last ? node->key_count : 0]);
+    return node;
+}
+
+template <typename T>
+typename BPlusTree<T>::SubTree BPlusTree<T>::growIfFull(SubTree s) {
+    if (s.root->key_count < 2 * t - 1) return s;
+    BPlusTreeNode<T>* root = new BPlusTreeNode<T>(t, false);
+    root->children[0] = s.root;
+    root->children_count = 1;
+    root->splitChild(0, s.root, *(this->vis));
+    return SubTree{root, s.height + 1};
+}
+
+// max(l) < sep <= min(r). 높은 쪽 트리의 가장자리 경로를 따라 낮은 쪽 트리의 높이까지
+// 내려가 sep와 함께 자식으로 붙이고, 붙인 루트가 모자라면 옆 형제와 맞춘다.
+template <typename T>
+typename BPlusTree<T>::SubTree BPlusTree<T>::joinAt(SubTree l, T sep, SubTree r) {
+    if (l.root == nullptr) return r;
+    if (r.root == nullptr) return l;
+
+    if (l.height == r.height) {
+        BPlusTreeNode<T>* root = new BPlusTreeNode<T>(t, false);
+        root->key[0] = sep;
+        root->key_count = 1;
+        root->children[0] = l.root;
+        root->children[1] = r.root;
+        root->children_count = 2;
+        rebalancePair(root, 0);
+        if (root->key_count == 0) {
+            delete root;
+            return l;
+        }
+        return SubTree{root, l.height + 1};
+    }
+
+    bool attach_right = l.height > r.height;
+    SubTree tall = growIfFull(attach_right ? l : r);
+    SubTree low = attach_right ? r : l;
+
+    BPlusTreeNode<T>* x = tall.root;
+    for (int h = tall.height; h > low.height + 1; h--) {
+        int i = attach_right ? x->key_count : 0;
+        BPlusTreeNode<T>* c = dynamic_cast<BPlusTreeNode<T>*>(x->children[i]);
+        if (c->key_count == 2 * t - 1) {
+            x->splitChild(i, c, *(this->vis));
+            i = attach_right ? x->key_count : 0;
+        }
+        x = dynamic_cast<BPlusTreeNode<T>*>(x->children[i]);
+    }
+
+    if (attach_right) {
+        x->key[x->key_count] = sep;
+        x->children[x->key_count + 1] = low.root;
+    } else {
+        for (int j = x->key_count; j > 0; j--) x->key[j] = x->key[j - 1];
+        for (int j = x->key_count + 1; j > 0; j--) x->children[j] = x->children[j - 1];
+        x->key[0] = sep;
+        x->children[0] = low.root;
+    }
+    x->key_count++;
+    x->children_count = x->key_count + 1;
+
+    if (low.root->key_count < t - 1)
+        rebalancePair(x, attach_right ? x->key_count - 1 : 0);
+    return tall;
+}
+
+// p의 i, i+1번 자식을 한 줄로 모아 한 노드에 들어가면 합치고, 아니면 반씩 나눈다.
+// 리프는 구분 키를 내려받지 않고 오른쪽 리프의 첫 키를 새 구분 키로 올린다.
+template <typename T>
+void BPlusTree<T>::rebalancePair(BPlusTreeNode<T>* p, int i) {
+    BPlusTreeNode<T>* a = dynamic_cast<BPlusTreeNode<T>*>(p->children[i]);
+    BPlusTreeNode<T>* b = dynamic_cast<BPlusTreeNode<T>*>(p->children[i + 1]);
+    bool leaf = a->is_leaf_node();
+
+    vector<T> keys(a->key.begin(), a->key.begin() + a->key_count);
+    vector<bool> tombs(a->tombstone.begin(), a->tombstone.begin() + a->key_count);
+    vector<DataNode<T>*> kids;
+    if (leaf) {
+        keys.insert(keys.end(), b->key.begin(), b->key.begin() + b->key_count);
+        tombs.insert(tombs.end(), b->tombstone.begin(), b->tombstone.begin() + b->key_count);
+    } else {
+        keys.push_back(p->key[i]);
+        keys.insert(keys.end(), b->key.begin(), b->key.begin() + b->key_count);
+        kids.assign(a->children.begin(), a->children.begin() + a->key_count + 1);
+        kids.insert(kids.end(), b->children.begin(), b->children.begin() + b->key_count + 1);
+    }
+
+    auto fill = [&](BPlusTreeNode<T>* node, int from, int count) {
+        for (int j = 0; j < count; j++) node->key[j] = keys[from + j];
+        fill_n(node->tombstone.begin(), node->tombstone.size(), false);
+        fill_n(node->children.begin(), node->children.size(), nullptr);
+        if (leaf) {
+            for (int j = 0; j < count; j++) node->tombstone[j] = tombs[from + j];
+            node->children_count = 0;
+        } else {
+            for (int j = 0; j <= count; j++) node->children[j] = kids[from + j];
+            node->children_count = count + 1;
+        }
+        node->key_count = count;
+    };
+
+    int total = keys.size();
+    if (total <= 2 * t - 1) {
+        fill(a, 0, total);
+        if (leaf) a->next = b->next;
+        delete b;
+        for (int j = i; j < p->key_count - 1; j++) p->key[j] = p->key[j + 1];
+        for (int j = i + 1; j < p->key_count; j++) p->children[j] = p->children[j + 1];
+        p->children[p->key_count] = nullptr;
+        p->key_count--;
+        p->children_count = p->key_count + 1;
+    } else if (leaf) {
+        int left = total / 2;
+        fill(a, 0, left);
+        fill(b, left, total - left);
+        p->key[i] = b->key[0];
+    } else {
+        int left = total / 2;
+        fill(a, 0, left);
+        p->key[i] = keys[left];
+        fill(b, left + 1, total - left - 1);
+    }
+}
+
+// x의 key[from, to)만 갖는 조각. 내부 노드는 children[from, to]도 가져가고 키가 없으면
+// 그 자식 서브트리 자체가 된다. 리프 조각은 원래 리프의 next를 이어받는다.
+template <typename T>
+typename BPlusTree<T>::SubTree BPlusTree<T>::keyRange(BPlusTreeNode<T>* x, int from, int to, int height) {
+    bool leaf = x->is_leaf_node();
+    if (from == to) {
+        if (leaf) return SubTree{};
+        return SubTree{dynamic_cast<BPlusTreeNode<T>*>(x->children[from]), height - 1};
+    }
+
+    BPlusTreeNode<T>* node = new BPlusTreeNode<T>(t, leaf);
+    for (int j = from; j < to; j++) {
+        node->key[j - from] = x->key[j];
+        node->tombstone[j - from] = x->tombstone[j];
+    }
+    node->key_count = to - from;
+    if (leaf) {
+        node->next = x->next;
+    } else {
+        for (int j = from; j <= to; j++) node->children[j - from] = x->children[j];
+        node->children_count = to - from + 1;
+    }
+    return SubTree{node, height};
+}
+
+template <typename T>
+void BPlusTree<T>::splitAt(SubTree s, T key, SubTree& l, SubTree& r) {
+    BPlusTreeNode<T>* x = s.root;
+    this->stats.visited++;
+    int n = x->key_count;
+
+    if (x->is_leaf_node()) {
+        int i = x->findKey(key);
+        r = keyRange(x, i, n, 1);
+        // 왼쪽 조각은 x를 그대로 써서 앞 리프에서 오는 next 링크를 살린다.
+        if (i > 0) {
+            x->key_count = i;
+            fill(x->tombstone.begin() + i, x->tombstone.end(), false);
+            l = SubTree{x, 1};
+        } else {
+            l = SubTree{};
+            delete x;
+        }
+        return;
+    }
+
+    int i = 0;
+    while (i < n && key >= x->key[i]) i++;
+
+    SubTree lf, rf;
+    if (i > 0) lf = keyRange(x, 0, i - 1, s.height);
+    if (i < n) rf = keyRange(x, i + 1, n, s.height);
+    T left_sep = i > 0 ? x->key[i - 1] : key;
+    T right_sep = i < n ? x->key[i] : key;
+    SubTree child{dynamic_cast<BPlusTreeNode<T>*>(x->children[i]), s.height - 1};
+    delete x;
+
+    SubTree dl, dr;
+    splitAt(child, key, dl, dr);
+    l = i > 0 ? joinAt(lf, left_sep, dl) : dl;
+    r = i < n ? joinAt(dr, right_sep, rf) : dr;
+}
@@ -4,9 +4,12 @@
 #include "tree.hpp"
 #include "node.hpp"
 #include "../visualizer/visualizer.hpp"
+#include "binary_bound.hpp"
 
 enum class Color;
 
+template <typename T> class BST;
+
 template <typename T>
 class BSTNode : public DataNode<T> {
 public:
@@ -22,15 +25,31 @@ public:
 
 private:
     BSTNode<T>* minValueNode(BSTNode<T>* node);
+
+    friend class BST<T>;
 };
 
 template <typename T>
 class BST : public DataTree<T> {
 public:
+    // BSTNode에는 부모 링크가 없으므로 루트부터 마지막 노드까지의 경로를 기억한다.
+    // remove가 일어나면 version이 바뀌어 다음 탐색은 루트부터 시작한다.
+    struct Finger {
+        vector<BSTNode<T>*> path;
+        long long version = -1;
+    };
+
     bool search(T target);
+    bool fingerSearch(T target, Finger& finger);
     bool insert(T entry);
     bool remove(T target);
     bool rangeSearch(T begin, T end);
+
+protected:
+    optional<T> bound(T x, bool greater, bool inclusive) override;
+
+private:
+    long long version = 0;
 };
 
 template <typename T>
@@ -293,6 +312,76 @@ bool BST<T>::search(T target) {
     return dynamic_cast<BSTNode<T>*>(this->root_ptr)->search(target, *(this->vis));
 }
 
+// 경로의 마지막 노드에서 target 쪽 경계(같은 방향 자식으로 이어진 구간의 부모)를
+// 넘지 않는 곳까지만 경로를 되감은 뒤 거기서부터 내려간다.
+template <typename T>
+bool BST<T>::fingerSearch(T target, Finger& finger) {
+    this->vis->clear();
+    this->vis->setTitle("Finger searching for target: " + DataNode<T>::toString(target));
+
+    if (this->root_ptr == nullptr) {
+        this->vis->setMessage("Tree is empty.");
+        this->vis->render();
+        return false;
+    }
+
+    vector<BSTNode<T>*>& path = finger.path;
+    if (finger.version != version || path.empty() || path[0] != this->root_ptr)
+        path.assign(1, dynamic_cast<BSTNode<T>*>(this->root_ptr));
+    finger.version = version;
+
+    while (path.size() > 1 && target != path.back()->key[0]) {
+        int dir = target > path.back()->key[0] ? 1 : 0;
+        size_t i = path.size() - 1;
+        while (i > 0 && path[i - 1]->children[dir] == path[i]) {
+            this->stats.visited++;
+            i--;
+        }
+        if (i == 0) break;
+
+        BSTNode<T>* bound = path[i - 1];
+        this->stats.visited++;
+        if (dir == 1 ? target < bound->key[0] : target > bound->key[0]) break;
+
+        path.resize(i);
+        this->vis->setColor(bound, Color::CYAN);
+        this->vis->setMessage("Target is beyond " + DataNode<T>::toString(bound->key[0]) + ".\n-> Climbing up");
+        this->vis->render();
+    }
+
+    BSTNode<T>* current = path.back();
+    while (true) {
+        this->stats.visited++;
+        this->vis->setColor(current, Color::YELLOW);
+        this->vis->setMessage("Comparing key with target");
+        this->vis->render();
+
+        if (target == current->key[0]) {
+            this->vis->setMessage("Found target!");
+            this->vis->setColor(current, Color::GREEN);
+            this->vis->render();
+            return true;
+        }
+
+        BSTNode<T>* next = dynamic_cast<BSTNode<T>*>(current->children[target < current->key[0] ? 0 : 1]);
+        if (next == nullptr) {
+            this->vis->setMessage("Target not found. End of path.");
+            this->vis->setColor(current, Color::RED);
+            this->vis->render();
+            return false;
+        }
+        this->vis->setColor(current, Color::CYAN);
+        path.push_back(next);
+        current = next;
+    }
+}
+
+template <typename T>
+optional<T> BST<T>::bound(T x, bool greater, bool inclusive) {
+    return this->template binaryBound<BSTNode<T>>(x, greater, inclusive,
+                                                  [this](BSTNode<T>* n) { this->vis->setColor(n, Color::RESET); });
+}
+
 template <typename T>
 bool BST<T>::insert(T entry) {
     this->vis->clear();
@@ -327,6 +416,7 @@ bool BST<T>::remove(T target) {
     }
 
     this->root_ptr = dynamic_cast<BSTNode<T>*>(this->root_ptr)->remove(target, *(this->vis));
+    version++;
     
     this->vis->clear();
     this->vis->setMessage("Removal operation finished.");
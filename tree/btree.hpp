@@ -1,16 +1,60 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <new>
 #include "tree.hpp"
 #include "node.hpp"
+#include "snapshot.hpp"
+#include "bloom_filter.hpp"
+#include "forkjoin.hpp"
 #include "../visualizer/visualizer.hpp"
 
 template <typename T> class BTree;
 
+// 노드 블록 안의 고정 길이 배열. vector처럼 [], begin/end, size로 쓴다.
+template <typename E>
+struct NodeArray {
+    E* data;
+    int n;
+
+    E& operator[](int i) { return data[i]; }
+    const E& operator[](int i) const { return data[i]; }
+    E* begin() { return data; }
+    E* end() { return data + n; }
+    int size() const { return n; }
+};
+
+// 노드 내용은 캐시 라인에 맞춘 블록 하나에 hot/cold로 나눠 둔다.
+//   [key_count | t | key[2t-1]] (패딩) [children[2t]]  <- 64바이트 경계
+// 탐색은 앞쪽의 키 라인만 비교하고 마지막에 자식 포인터 하나만 읽는다.
+// 노드 객체에는 블록 포인터만 두고 (DataNode의 key/children/key_count는 쓰지 않는다) 내용은 접근자로 읽는다.
 template <typename T>
 class BTreeNode : public DataNode<T> {
-    int t; // Minimum degree
+    char* block;
+
+protected:
+    int& keyCount() const { return *reinterpret_cast<int*>(block); }
+    int degree() const { return reinterpret_cast<const int*>(block)[1]; } // Minimum degree
+    NodeArray<T> keys() const { return {reinterpret_cast<T*>(block + keysAt()), 2 * degree() - 1}; }
+    NodeArray<DataNode<T>*> childPtrs() const {
+        return {reinterpret_cast<DataNode<T>**>(block + childrenAt(degree())), 2 * degree()};
+    }
+
+private:
+    static const size_t LINE = 64;
+    static size_t keysAt() { return (2 * sizeof(int) + alignof(T) - 1) / alignof(T) * alignof(T); }
+    static size_t childrenAt(int t) { return (keysAt() + sizeof(T) * (2 * t - 1) + LINE - 1) / LINE * LINE; }
+    static size_t blockSize(int t) { return (childrenAt(t) + sizeof(DataNode<T>*) * 2 * t + LINE - 1) / LINE * LINE; }
+    static char* allocateBlock(int t);
+
 public:
     BTreeNode(int _t, bool leaf);
+    ~BTreeNode();
+
+    int getKeyCount() const { return keyCount(); }
 
     bool search(T k, Visualizer& vis);
     bool insertNonFull(T k, Visualizer& vis);
@@ -30,6 +74,8 @@ public:
     void merge(int idx, Visualizer &vis);
 
     bool is_leaf_node();
+    // 블록 앞쪽의 헤더와 키 라인을 미리 부른다 (자식 라인은 내려갈 자식이 정해진 뒤에 부른다).
+    void prefetchKeys() const;
 
     void draw(Visualizer& vis);
 
@@ -46,29 +92,113 @@ public:
     bool insert(T k);
     bool remove(T k);
     bool rangeSearch(T begin, T end);
+
+    // [begin, end] 안의 키를 키 순서대로 acc(r, k)에 넘겨 모은다. 범위에 걸린 자식들을 반씩 나눠
+    // fork-join으로 따로 훑고 (오른쪽 몫은 init에서 새로 시작), 결과를 combine(왼쪽, 오른쪽)으로 합친다.
+    // combine은 결합법칙만 만족하면 된다. 낮은 서브트리는 나누지 않는다. 시각화는 하지 않는다.
+    template <typename R, typename F, typename C>
+    R parallelRangeReduce(T begin, T end, R init, F acc, C combine, int depth = defaultForkDepth());
+    // [begin, end] 안의 키를 키 순서대로 돌려준다 (parallelRangeReduce로 이어 붙인다).
+    vector<T> parallelRangeCollect(T begin, T end, int depth = defaultForkDepth());
+
+    // key 미만은 left로, key 이상은 right로 옮긴다. this는 비게 되고
+    // left/right는 기존 내용을 버리고 this의 차수를 따른다. key가 있었는지 반환.
+    bool split(T key, BTree<T>& left, BTree<T>& right);
+    // this의 모든 키 < right의 모든 키일 때 right를 뒤에 이어 붙인다. right는 비게 된다.
+    bool concat(BTree<T>& right);
+
+    // 노드를 BFS 순서로 path에 쓴다. 읽기는 SnapshotView<T>로 한다 (snapshot.hpp 참고).
+    bool saveSnapshot(const string& path);
+
+    // search(k)가 읽는 서로 다른 캐시 라인 수 (노드 객체, 비교한 키, 따라간 자식 포인터). 레이아웃 확인용.
+    int searchFootprint(T k);
+
+    // keys를 group개씩 묶어 한 층씩 나란히 내려간다. 층마다 (키 라인 부르기 / 키 비교 후 자식 포인터 라인 부르기 /
+    // 자식 노드 부르기) 세 단계를 group개에 대해 차례로 돌려서 서로 독립인 miss가 한꺼번에 떠 있게 한다.
+    // 결과 i는 search(keys[i])와 같다. 시각화와 Bloom 필터는 거치지 않는다.
+    vector<bool> searchBatch(const vector<T>& keys, int group = 16);
+
+    // search 앞에 블록 Bloom 필터를 둔다. capacity(0이면 현재 키 수의 두 배)를 넘게 차거나
+    // 지운 키가 많아지면 남은 키로 다시 만든다. 끄면 필터를 버린다.
+    void setBloomFilter(bool enabled, double fpr = 0.01, size_t capacity = 0);
+    BloomStats getBloomStats() const { return bloom ? bloom->getStats() : BloomStats{}; }
+    void resetBloomStats() {
+        if (bloom) bloom->resetStats();
+    }
+
+protected:
+    optional<T> bound(T x, bool greater, bool inclusive) override;
+
+private:
+    // split/concat 중간 결과. height는 리프가 1, 빈 트리가 0이다.
+    struct SubTree {
+        BTreeNode<T>* root = nullptr;
+        int height = 0;
+    };
+
+    SubTree whole();
+    void adopt(SubTree s);
+    SubTree growIfFull(SubTree s);
+    SubTree insertEdge(SubTree s, T k, bool front);
+    SubTree joinAt(SubTree l, T k, SubTree r);
+    void rebalancePair(BTreeNode<T>* p, int i);
+    SubTree keyRange(BTreeNode<T>* x, int from, int to, int height);
+    void splitAt(SubTree s, T key, SubTree& l, bool& found, SubTree& r);
+    static void freeSubtree(BTreeNode<T>* node);
+    static void collectKeys(BTreeNode<T>* node, vector<T>& out);
+
+    // 이보다 낮은 노드의 자식들은 스레드를 띄우는 비용이 더 크므로 나누지 않는다 (리프가 높이 1).
+    static constexpr int fork_min_height = 3;
+
+    // x의 자식 from..to와 그 사이 키를 훑는다. lo는 자식 from에만, hi는 자식 to에만 걸리는 경계이고
+    // nullptr이면 그쪽으로는 제한이 없다 (범위 안에 온전히 들어간 자식).
+    template <typename R, typename F, typename C>
+    static void reduceChildren(BTreeNode<T>* x, int height, int from, int to, const T* lo, const T* hi,
+                               int depth, R& r, const R& init, F& acc, C& combine);
+    template <typename R, typename F, typename C>
+    static void reduceRange(BTreeNode<T>* x, int height, const T* lo, const T* hi,
+                            int depth, R& r, const R& init, F& acc, C& combine);
+
+    unique_ptr<BloomFilter<T>> bloom;
+    void rebuildBloom();
 };
 
 
 template <typename T>
-BTreeNode<T>::BTreeNode(int _t, bool leaf) {
-    t = _t;
-    // B-Tree 노드의 최대 키 개수: 2*t - 1
-    // 최대 자식 개수: 2*t
-    this->key.resize(2 * t - 1);
-    this->children.resize(2 * t, nullptr);
-    this->key_count = 0;
-    
+char* BTreeNode<T>::allocateBlock(int t) {
+    char* block = static_cast<char*>(::operator new(blockSize(t), align_val_t(LINE)));
+    new (block) int(0);
+    new (block + sizeof(int)) int(t);
+    for (int i = 0; i < 2 * t - 1; i++) new (block + keysAt() + sizeof(T) * i) T();
+    for (int i = 0; i < 2 * t; i++) new (block + childrenAt(t) + sizeof(DataNode<T>*) * i) DataNode<T>*(nullptr);
+    return block;
+}
+
+// B-Tree 노드의 최대 키 개수: 2*t - 1
+// 최대 자식 개수: 2*t
+template <typename T>
+BTreeNode<T>::BTreeNode(int _t, bool leaf)
+    : block(allocateBlock(_t)) {
     // 리프 노드일 경우 children_count는 0 (is_leaf() 판단용)
     // 내부 노드일 경우 나중에 자식이 추가되면 children_count 업데이트
     this->children_count = 0; 
 }
 
+template <typename T>
+BTreeNode<T>::~BTreeNode() {
+    for (T& k : keys()) k.~T();
+    ::operator delete(block, align_val_t(LINE));
+}
+
+template <typename T>
+void BTreeNode<T>::prefetchKeys() const {
+    for (size_t off = 0; off < childrenAt(degree()); off += LINE) __builtin_prefetch(block + off);
+}
+
+// 내부 노드는 항상 children[0]이 있으므로 첫 자식만 보면 된다 (자식 라인 하나만 읽는다).
 template <typename T>
 bool BTreeNode<T>::is_leaf_node() {
-    for(auto c : this->children) {
-        if(c != nullptr) return false;
-    }
-    return true;
+    return this->childPtrs()[0] == nullptr;
 }
 
 template <typename T>
@@ -79,33 +209,35 @@ bool BTreeNode<T>::search(T k, Visualizer& vis) {
     vis.setColor(this, Color::YELLOW);
     vis.render();
 
-    while (i < this->key_count && k > this->key[i]) {
+    while (i < this->keyCount() && k > this->keys()[i]) {
         vis.setColor(this, i, Color::CYAN);
         i++;
     }
     vis.render();
 
-    if (i < this->key_count && this->key[i] == k) {
+    if (i < this->keyCount() && this->keys()[i] == k) {
         vis.setMessage("Key " + DataNode<T>::toString(k) + " found!");
         vis.setColor(this, i, Color::GREEN);
         vis.render();
         return true;
     }
 
-    if (is_leaf_node()) {
+    // 리프는 자식이 모두 비어 있으므로 내려갈 자식 포인터 하나만 읽어 리프인지도 판단한다.
+    BTreeNode* child = dynamic_cast<BTreeNode*>(this->childPtrs()[i]);
+    if (child == nullptr) {
         vis.setMessage("Reached leaf node. Key not found.");
         vis.setColor(this, Color::RED);
         vis.render();
         return false;
     }
 
-    vis.setMessage("Key > " + (i > 0 ? DataNode<T>::toString(this->key[i-1]) : "-INF") + 
-                   " and Key < " + (i < this->key_count ? DataNode<T>::toString(this->key[i]) : "INF") + 
+    vis.setMessage("Key > " + (i > 0 ? DataNode<T>::toString(this->keys()[i-1]) : "-INF") + 
+                   " and Key < " + (i < this->keyCount() ? DataNode<T>::toString(this->keys()[i]) : "INF") + 
                    "\n-> Moving to child index " + DataNode<int>::toString(i));
     vis.setColor(this, Color::RESET);
     vis.render();
 
-    return dynamic_cast<BTreeNode*>(this->children[i])->search(k, vis);
+    return child->search(k, vis);
 }
 
 template <typename T>
@@ -114,39 +246,39 @@ void BTreeNode<T>::splitChild(int i, BTreeNode<T>* y, Visualizer& vis) {
     vis.setColor(y, Color::RED);
     vis.render();
 
-    BTreeNode<T>* z = new BTreeNode<T>(y->t, y->is_leaf_node());
-    z->key_count = t - 1;
+    BTreeNode<T>* z = new BTreeNode<T>(y->degree(), y->is_leaf_node());
+    z->keyCount() = degree() - 1;
 
-    for (int j = 0; j < t - 1; j++) {
-        z->key[j] = y->key[j + t];
+    for (int j = 0; j < degree() - 1; j++) {
+        z->keys()[j] = y->keys()[j + degree()];
     }
 
     if (!y->is_leaf_node()) {
-        for (int j = 0; j < t; j++) {
-            z->children[j] = y->children[j + t];
-            if (z->children[j]) z->children_count++;
-            y->children[j + t] = nullptr;
+        for (int j = 0; j < degree(); j++) {
+            z->childPtrs()[j] = y->childPtrs()[j + degree()];
+            if (z->childPtrs()[j]) z->children_count++;
+            y->childPtrs()[j + degree()] = nullptr;
             if (y->children_count > 0) y->children_count--;
         }
     }
 
-    y->key_count = t - 1;
+    y->keyCount() = degree() - 1;
 
-    for (int j = this->key_count; j >= i + 1; j--) {
-        this->children[j + 1] = this->children[j];
+    for (int j = this->keyCount(); j >= i + 1; j--) {
+        this->childPtrs()[j + 1] = this->childPtrs()[j];
     }
 
-    this->children[i + 1] = z;
+    this->childPtrs()[i + 1] = z;
     this->children_count++; 
 
-    for (int j = this->key_count - 1; j >= i; j--) {
-        this->key[j + 1] = this->key[j];
+    for (int j = this->keyCount() - 1; j >= i; j--) {
+        this->keys()[j + 1] = this->keys()[j];
     }
 
-    this->key[i] = y->key[t - 1];
-    this->key_count++;
+    this->keys()[i] = y->keys()[degree() - 1];
+    this->keyCount()++;
 
-    vis.setMessage("Split complete. Median " + DataNode<T>::toString(this->key[i]) + " moved up.");
+    vis.setMessage("Split complete. Median " + DataNode<T>::toString(this->keys()[i]) + " moved up.");
     vis.setColor(this, i, Color::MAGENTA);
     vis.setColor(y, Color::RESET);
     vis.render();
@@ -154,14 +286,14 @@ void BTreeNode<T>::splitChild(int i, BTreeNode<T>* y, Visualizer& vis) {
 
 template <typename T>
 bool BTreeNode<T>::insertNonFull(T k, Visualizer& vis) {
-    int i = this->key_count - 1;
+    int i = this->keyCount() - 1;
 
     vis.setColor(this, Color::YELLOW);
     vis.render();
 
     int check_idx = 0;
-    while (check_idx < this->key_count && this->key[check_idx] < k) check_idx++;
-    if (check_idx < this->key_count && this->key[check_idx] == k) {
+    while (check_idx < this->keyCount() && this->keys()[check_idx] < k) check_idx++;
+    if (check_idx < this->keyCount() && this->keys()[check_idx] == k) {
         vis.setMessage("Key " + DataNode<T>::toString(k) + " already exists.");
         vis.setColor(this, check_idx, Color::RED);
         vis.render();
@@ -170,47 +302,54 @@ bool BTreeNode<T>::insertNonFull(T k, Visualizer& vis) {
 
     if (is_leaf_node()) {
         vis.setMessage("Inserting " + DataNode<T>::toString(k) + " into leaf node.");
-        while (i >= 0 && this->key[i] > k) {
-            this->key[i + 1] = this->key[i];
+        while (i >= 0 && this->keys()[i] > k) {
+            this->keys()[i + 1] = this->keys()[i];
             i--;
         }
 
-        this->key[i + 1] = k;
-        this->key_count++;
+        this->keys()[i + 1] = k;
+        this->keyCount()++;
 
         vis.setColor(this, i + 1, Color::GREEN);
         vis.render();
         vis.setColor(this, Color::RESET);
         return true;
     } else {
-        while (i >= 0 && this->key[i] > k) {
+        while (i >= 0 && this->keys()[i] > k) {
             i--;
         }
         i++;
 
         vis.setMessage("Moving down to child " + DataNode<int>::toString(i));
         
-        BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->children[i]);
+        BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[i]);
         
-        if (child->key_count == 2 * t - 1) {
+        if (child->keyCount() == 2 * degree() - 1) {
             vis.setMessage("Child is full. Splitting first.");
             vis.render();
             
             splitChild(i, child, vis);
 
-            if (this->key[i] < k) {
+            // 올라온 중간 키가 k이면 이미 존재하는 키다.
+            if (this->keys()[i] == k) {
+                vis.setMessage("Key " + DataNode<T>::toString(k) + " already exists.");
+                vis.setColor(this, i, Color::RED);
+                vis.render();
+                return false;
+            }
+            if (this->keys()[i] < k) {
                 i++;
             }
         }
         
-        return dynamic_cast<BTreeNode<T>*>(this->children[i])->insertNonFull(k, vis);
+        return dynamic_cast<BTreeNode<T>*>(this->childPtrs()[i])->insertNonFull(k, vis);
     }
 }
 
 template <typename T>
 int BTreeNode<T>::findKey(T k) {
     int idx = 0;
-    while (idx < this->key_count && this->key[idx] < k) ++idx;
+    while (idx < this->keyCount() && this->keys()[idx] < k) ++idx;
     return idx;
 }
 
@@ -223,7 +362,7 @@ bool BTreeNode<T>::remove(T k, Visualizer& vis) {
     int idx = findKey(k);
 
     // Case 1: The key k is in this node
-    if (idx < this->key_count && this->key[idx] == k) {
+    if (idx < this->keyCount() && this->keys()[idx] == k) {
         vis.setMessage("Found key " + DataNode<T>::toString(k) + " in this node.");
         vis.setColor(this, idx, Color::MAGENTA);
         vis.render();
@@ -246,11 +385,11 @@ bool BTreeNode<T>::remove(T k, Visualizer& vis) {
         }
 
         // Flag to indicate if the key is present in the sub-tree rooted at the last child
-        bool flag = (idx == this->key_count);
+        bool flag = (idx == this->keyCount());
         
-        BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->children[idx]);
+        BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx]);
 
-        if (child->key_count < t) {
+        if (child->keyCount() < degree()) {
             vis.setMessage("Child " + DataNode<int>::toString(idx) + " has too few keys. Filling...");
             vis.render();
             fill(idx, vis);
@@ -258,43 +397,43 @@ bool BTreeNode<T>::remove(T k, Visualizer& vis) {
 
         // If the last child has been merged, it must have merged with the previous child
         // so we recurse on the (idx-1)th child. Else, we recurse on the (idx)th child
-        if (flag && idx > this->key_count) {
-             return dynamic_cast<BTreeNode<T>*>(this->children[idx - 1])->remove(k, vis);
+        if (flag && idx > this->keyCount()) {
+             return dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx - 1])->remove(k, vis);
         } else {
-             return dynamic_cast<BTreeNode<T>*>(this->children[idx])->remove(k, vis);
+             return dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx])->remove(k, vis);
         }
     }
 }
 
 template <typename T>
 void BTreeNode<T>::removeFromLeaf(int idx, Visualizer& vis) {
-    vis.setMessage("Removing " + DataNode<T>::toString(this->key[idx]) + " from leaf.");
+    vis.setMessage("Removing " + DataNode<T>::toString(this->keys()[idx]) + " from leaf.");
     vis.render();
-    for (int i = idx + 1; i < this->key_count; ++i)
-        this->key[i - 1] = this->key[i];
-    this->key_count--;
+    for (int i = idx + 1; i < this->keyCount(); ++i)
+        this->keys()[i - 1] = this->keys()[i];
+    this->keyCount()--;
 }
 
 template <typename T>
 void BTreeNode<T>::removeFromNonLeaf(int idx, Visualizer& vis) {
-    T k = this->key[idx];
-    BTreeNode<T>* leftChild = dynamic_cast<BTreeNode<T>*>(this->children[idx]);
-    BTreeNode<T>* rightChild = dynamic_cast<BTreeNode<T>*>(this->children[idx + 1]);
+    T k = this->keys()[idx];
+    BTreeNode<T>* leftChild = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx]);
+    BTreeNode<T>* rightChild = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx + 1]);
 
-    if (leftChild->key_count >= t) {
+    if (leftChild->keyCount() >= degree()) {
         vis.setMessage("Left child has enough keys. Finding predecessor.");
         vis.render();
         T pred = getPredecessor(idx);
-        this->key[idx] = pred;
+        this->keys()[idx] = pred;
         vis.setMessage("Replaced " + DataNode<T>::toString(k) + " with predecessor " + DataNode<T>::toString(pred));
         vis.render();
         leftChild->remove(pred, vis);
     }
-    else if (rightChild->key_count >= t) {
+    else if (rightChild->keyCount() >= degree()) {
         vis.setMessage("Right child has enough keys. Finding successor.");
         vis.render();
         T succ = getSuccessor(idx);
-        this->key[idx] = succ;
+        this->keys()[idx] = succ;
         vis.setMessage("Replaced " + DataNode<T>::toString(k) + " with successor " + DataNode<T>::toString(succ));
         vis.render();
         rightChild->remove(succ, vis);
@@ -309,28 +448,28 @@ void BTreeNode<T>::removeFromNonLeaf(int idx, Visualizer& vis) {
 
 template <typename T>
 T BTreeNode<T>::getPredecessor(int idx) {
-    BTreeNode<T>* cur = dynamic_cast<BTreeNode<T>*>(this->children[idx]);
+    BTreeNode<T>* cur = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx]);
     while (!cur->is_leaf_node())
-        cur = dynamic_cast<BTreeNode<T>*>(cur->children[cur->key_count]);
-    return cur->key[cur->key_count - 1];
+        cur = dynamic_cast<BTreeNode<T>*>(cur->childPtrs()[cur->keyCount()]);
+    return cur->keys()[cur->keyCount() - 1];
 }
 
 template <typename T>
 T BTreeNode<T>::getSuccessor(int idx) {
-    BTreeNode<T>* cur = dynamic_cast<BTreeNode<T>*>(this->children[idx + 1]);
+    BTreeNode<T>* cur = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx + 1]);
     while (!cur->is_leaf_node())
-        cur = dynamic_cast<BTreeNode<T>*>(cur->children[0]);
-    return cur->key[0];
+        cur = dynamic_cast<BTreeNode<T>*>(cur->childPtrs()[0]);
+    return cur->keys()[0];
 }
 
 template <typename T>
 void BTreeNode<T>::fill(int idx, Visualizer& vis) {
-    if (idx != 0 && dynamic_cast<BTreeNode<T>*>(this->children[idx - 1])->key_count >= t)
+    if (idx != 0 && dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx - 1])->keyCount() >= degree())
         borrowFromPrev(idx, vis);
-    else if (idx != this->key_count && dynamic_cast<BTreeNode<T>*>(this->children[idx + 1])->key_count >= t)
+    else if (idx != this->keyCount() && dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx + 1])->keyCount() >= degree())
         borrowFromNext(idx, vis);
     else {
-        if (idx != this->key_count)
+        if (idx != this->keyCount())
             merge(idx, vis);
         else
             merge(idx - 1, vis);
@@ -342,28 +481,28 @@ void BTreeNode<T>::borrowFromPrev(int idx, Visualizer& vis) {
     vis.setMessage("Borrowing from left sibling.");
     vis.render();
 
-    BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->children[idx]);
-    BTreeNode<T>* sibling = dynamic_cast<BTreeNode<T>*>(this->children[idx - 1]);
+    BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx]);
+    BTreeNode<T>* sibling = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx - 1]);
 
-    for (int i = child->key_count - 1; i >= 0; --i)
-        child->key[i + 1] = child->key[i];
+    for (int i = child->keyCount() - 1; i >= 0; --i)
+        child->keys()[i + 1] = child->keys()[i];
 
     if (!child->is_leaf_node()) {
-        for (int i = child->key_count; i >= 0; --i)
-            child->children[i + 1] = child->children[i];
+        for (int i = child->keyCount(); i >= 0; --i)
+            child->childPtrs()[i + 1] = child->childPtrs()[i];
     }
 
-    child->key[0] = this->key[idx - 1];
+    child->keys()[0] = this->keys()[idx - 1];
 
     if (!child->is_leaf_node())
-        child->children[0] = sibling->children[sibling->key_count];
+        child->childPtrs()[0] = sibling->childPtrs()[sibling->keyCount()];
 
-    this->key[idx - 1] = sibling->key[sibling->key_count - 1];
+    this->keys()[idx - 1] = sibling->keys()[sibling->keyCount() - 1];
 
-    child->key_count += 1;
-    sibling->key_count -= 1;
+    child->keyCount() += 1;
+    sibling->keyCount() -= 1;
     
-    // Update children counts if needed for consistency, though key_count is primary
+    // Update children counts if needed for consistency, though keyCount() is primary
     if(!child->is_leaf_node()) child->children_count++;
     if(!sibling->is_leaf_node()) sibling->children_count--;
 
@@ -376,26 +515,26 @@ void BTreeNode<T>::borrowFromNext(int idx, Visualizer& vis) {
     vis.setMessage("Borrowing from right sibling.");
     vis.render();
 
-    BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->children[idx]);
-    BTreeNode<T>* sibling = dynamic_cast<BTreeNode<T>*>(this->children[idx + 1]);
+    BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx]);
+    BTreeNode<T>* sibling = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx + 1]);
 
-    child->key[child->key_count] = this->key[idx];
+    child->keys()[child->keyCount()] = this->keys()[idx];
 
     if (!child->is_leaf_node())
-        child->children[child->key_count + 1] = sibling->children[0];
+        child->childPtrs()[child->keyCount() + 1] = sibling->childPtrs()[0];
 
-    this->key[idx] = sibling->key[0];
+    this->keys()[idx] = sibling->keys()[0];
 
-    for (int i = 1; i < sibling->key_count; ++i)
-        sibling->key[i - 1] = sibling->key[i];
+    for (int i = 1; i < sibling->keyCount(); ++i)
+        sibling->keys()[i - 1] = sibling->keys()[i];
 
     if (!sibling->is_leaf_node()) {
-        for (int i = 1; i <= sibling->key_count; ++i)
-            sibling->children[i - 1] = sibling->children[i];
+        for (int i = 1; i <= sibling->keyCount(); ++i)
+            sibling->childPtrs()[i - 1] = sibling->childPtrs()[i];
     }
 
-    child->key_count += 1;
-    sibling->key_count -= 1;
+    child->keyCount() += 1;
+    sibling->keyCount() -= 1;
     
     if(!child->is_leaf_node()) child->children_count++;
     if(!sibling->is_leaf_node()) sibling->children_count--;
@@ -409,28 +548,28 @@ void BTreeNode<T>::merge(int idx, Visualizer& vis) {
     vis.setMessage("Merging children at index " + DataNode<int>::toString(idx));
     vis.render();
 
-    BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->children[idx]);
-    BTreeNode<T>* sibling = dynamic_cast<BTreeNode<T>*>(this->children[idx + 1]);
+    BTreeNode<T>* child = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx]);
+    BTreeNode<T>* sibling = dynamic_cast<BTreeNode<T>*>(this->childPtrs()[idx + 1]);
 
-    child->key[t - 1] = this->key[idx];
+    child->keys()[degree() - 1] = this->keys()[idx];
 
-    for (int i = 0; i < sibling->key_count; ++i)
-        child->key[i + t] = sibling->key[i];
+    for (int i = 0; i < sibling->keyCount(); ++i)
+        child->keys()[i + degree()] = sibling->keys()[i];
 
     if (!child->is_leaf_node()) {
-        for (int i = 0; i <= sibling->key_count; ++i)
-            child->children[i + t] = sibling->children[i];
+        for (int i = 0; i <= sibling->keyCount(); ++i)
+            child->childPtrs()[i + degree()] = sibling->childPtrs()[i];
     }
 
-    for (int i = idx + 1; i < this->key_count; ++i)
-        this->key[i - 1] = this->key[i];
+    for (int i = idx + 1; i < this->keyCount(); ++i)
+        this->keys()[i - 1] = this->keys()[i];
 
-    for (int i = idx + 2; i <= this->key_count; ++i)
-        this->children[i - 1] = this->children[i];
+    for (int i = idx + 2; i <= this->keyCount(); ++i)
+        this->childPtrs()[i - 1] = this->childPtrs()[i];
 
-    child->key_count += sibling->key_count + 1;
+    child->keyCount() += sibling->keyCount() + 1;
     child->children_count += sibling->children_count; // Rough update
-    this->key_count--;
+    this->keyCount()--;
     this->children_count--;
 
     delete sibling;
@@ -442,15 +581,15 @@ template <typename T>
 void BTreeNode<T>::rangeSearch(T begin, T end, Visualizer& vis, bool& found_any) {
     int i = 0;
     
-    while (i < this->key_count) {
-        T current_key = this->key[i];
+    while (i < this->keyCount()) {
+        T current_key = this->keys()[i];
         bool in_range = (current_key >= begin && current_key <= end);
 
         if (!this->is_leaf_node() && current_key > begin) {
             vis.setMessage("Key " + DataNode<T>::toString(current_key) + " > Begin (" + DataNode<T>::toString(begin) + ")\n-> Exploring child " + DataNode<int>::toString(i));
             vis.render();
             
-            dynamic_cast<BTreeNode<T>*>(this->children[i])->rangeSearch(begin, end, vis, found_any);
+            dynamic_cast<BTreeNode<T>*>(this->childPtrs()[i])->rangeSearch(begin, end, vis, found_any);
             
             vis.setColor(this, i, Color::YELLOW);
             vis.setMessage("Back to key " + DataNode<T>::toString(current_key));
@@ -478,11 +617,11 @@ void BTreeNode<T>::rangeSearch(T begin, T end, Visualizer& vis, bool& found_any)
         i++;
     }
 
-    if (!this->is_leaf_node() && this->key[i - 1] < end) {
+    if (!this->is_leaf_node() && this->keys()[i - 1] < end) {
         vis.setMessage("Last key < End (" + DataNode<T>::toString(end) + ")\n-> Exploring last child " + DataNode<int>::toString(i));
         vis.render();
 
-        dynamic_cast<BTreeNode<T>*>(this->children[i])->rangeSearch(begin, end, vis, found_any);
+        dynamic_cast<BTreeNode<T>*>(this->childPtrs()[i])->rangeSearch(begin, end, vis, found_any);
 
         vis.setMessage("Back from last child of node...");
         vis.render();
@@ -491,64 +630,64 @@ void BTreeNode<T>::rangeSearch(T begin, T end, Visualizer& vis, bool& found_any)
 
 template <typename T>
 void BTreeNode<T>::draw(Visualizer& vis) {
-    int n = this->key_count;
+    int n = this->keyCount();
     int mid = n / 2;
     bool is_odd = (n % 2 != 0);
 
     if (is_odd) {
-        if (!this->is_leaf() && this->children[n]) vis.printChild(this->children[n], Pos::UP, this, Pos::UP);
+        if (!this->is_leaf() && this->childPtrs()[n]) vis.printChild(this->childPtrs()[n], Pos::UP, this, Pos::UP);
         for (int i = n - 1; i > mid; --i) {
-            vis.printKey(Pos::UP, DataNode<T>::toString(this->key[i]), this, i);
+            vis.printKey(Pos::UP, DataNode<T>::toString(this->keys()[i]), this, i);
 
-            if (!this->is_leaf() && this->children[i]) 
-                vis.printChild(this->children[i], Pos::MID_NORM, this, Pos::UP);
+            if (!this->is_leaf() && this->childPtrs()[i]) 
+                vis.printChild(this->childPtrs()[i], Pos::MID_NORM, this, Pos::UP);
             else {
                 vis.printKeyConnection(this, Pos::UP);
             }
         }
 
-        vis.printKey(Pos::MID_NORM, DataNode<T>::toString(this->key[mid]), this, mid);
+        vis.printKey(Pos::MID_NORM, DataNode<T>::toString(this->keys()[mid]), this, mid);
 
         for (int i = mid - 1; i >= 0; --i) {
-            if (!this->is_leaf() && this->children[i + 1])
-                vis.printChild(this->children[i + 1], Pos::MID_NORM, this, Pos::DOWN);
+            if (!this->is_leaf() && this->childPtrs()[i + 1])
+                vis.printChild(this->childPtrs()[i + 1], Pos::MID_NORM, this, Pos::DOWN);
             else
                 vis.printKeyConnection(this, Pos::DOWN);
 
-            vis.printKey(Pos::DOWN, DataNode<T>::toString(this->key[i]), this, i);
+            vis.printKey(Pos::DOWN, DataNode<T>::toString(this->keys()[i]), this, i);
         }
-        if (!this->is_leaf() && this->children[0])
-            vis.printChild(this->children[0], Pos::DOWN, this, Pos::DOWN);
+        if (!this->is_leaf() && this->childPtrs()[0])
+            vis.printChild(this->childPtrs()[0], Pos::DOWN, this, Pos::DOWN);
     }
     else {
-        if (!this->is_leaf() && this->children[n]) vis.printChild(this->children[n], Pos::UP, this, Pos::UP);
+        if (!this->is_leaf() && this->childPtrs()[n]) vis.printChild(this->childPtrs()[n], Pos::UP, this, Pos::UP);
         for (int i = n - 1; i >= mid + 1; --i) {
-            vis.printKey(Pos::UP, DataNode<T>::toString(this->key[i]), this, i);
+            vis.printKey(Pos::UP, DataNode<T>::toString(this->keys()[i]), this, i);
             
-            if (!this->is_leaf() && this->children[i])
-                vis.printChild(this->children[i], Pos::MID_NORM, this, Pos::UP);
+            if (!this->is_leaf() && this->childPtrs()[i])
+                vis.printChild(this->childPtrs()[i], Pos::MID_NORM, this, Pos::UP);
             else if (i != mid)
                 vis.printKeyConnection(this, Pos::UP);
         }
-        vis.printKey(Pos::UP, DataNode<T>::toString(this->key[mid]), this, mid);
+        vis.printKey(Pos::UP, DataNode<T>::toString(this->keys()[mid]), this, mid);
 
-        if (!this->is_leaf() && this->children[mid]) {
-            vis.printChild(this->children[mid], Pos::MID_EVEN, this, Pos::MID_EVEN);
+        if (!this->is_leaf() && this->childPtrs()[mid]) {
+            vis.printChild(this->childPtrs()[mid], Pos::MID_EVEN, this, Pos::MID_EVEN);
         }
         else 
             vis.printKeyConnection(this, Pos::MID_EVEN);
 
         for (int i = mid - 1; i > 0; --i) {
-            vis.printKey(Pos::DOWN, DataNode<T>::toString(this->key[i]), this, i);
+            vis.printKey(Pos::DOWN, DataNode<T>::toString(this->keys()[i]), this, i);
 
-            if (!this->is_leaf() && this->children[i])
-                vis.printChild(this->children[i], Pos::MID_NORM, this, Pos::DOWN);
+            if (!this->is_leaf() && this->childPtrs()[i])
+                vis.printChild(this->childPtrs()[i], Pos::MID_NORM, this, Pos::DOWN);
             else
                 vis.printKeyConnection(this, Pos::MID_EVEN);
         }
-        vis.printKey(Pos::DOWN, DataNode<T>::toString(this->key[0]), this, 0);
-        if (!this->is_leaf() && this->children[0])
-            vis.printChild(this->children[0], Pos::DOWN, this, Pos::DOWN);
+        vis.printKey(Pos::DOWN, DataNode<T>::toString(this->keys()[0]), this, 0);
+        if (!this->is_leaf() && this->childPtrs()[0])
+            vis.printChild(this->childPtrs()[0], Pos::DOWN, this, Pos::DOWN);
     }
 }
 
@@ -564,7 +703,14 @@ bool BTree<T>::search(T k) {
         this->vis->render();
         return false;
     }
-    return dynamic_cast<BTreeNode<T>*>(this->root_ptr)->search(k, *(this->vis));
+    if (bloom && !bloom->mayContain(k)) {
+        this->vis->setMessage("Bloom filter: key is definitely absent.");
+        this->vis->render();
+        return false;
+    }
+    bool found = dynamic_cast<BTreeNode<T>*>(this->root_ptr)->search(k, *(this->vis));
+    if (bloom && !found) bloom->noteFalsePositive();
+    return found;
 }
 
 template <typename T>
@@ -572,6 +718,12 @@ bool BTree<T>::insert(T k) {
     this->vis->clear();
     this->vis->setTitle("Inserting: " + DataNode<T>::toString(k));
 
+    // 이미 있는 키를 다시 넣어도 같은 비트라 상관없으므로 먼저 넣어 둔다.
+    if (bloom) {
+        if (bloom->needsRebuild()) rebuildBloom();
+        bloom->add(k);
+    }
+
     bool inserted = false;
 
     if (this->root_ptr == nullptr) {
@@ -579,8 +731,8 @@ bool BTree<T>::insert(T k) {
         this->vis->render();
 
         BTreeNode<T>* root = new BTreeNode<T>(t, true);
-        root->key[0] = k;
-        root->key_count = 1;
+        root->keys()[0] = k;
+        root->keyCount() = 1;
         this->setRoot(root);
 
         this->vis->setColor(this->root_ptr, 0, Color::GREEN);
@@ -589,26 +741,32 @@ bool BTree<T>::insert(T k) {
     } else {
         BTreeNode<T>* r = dynamic_cast<BTreeNode<T>*>(this->root_ptr);
         
-        if (r->key_count == 2 * t - 1) {
+        if (r->keyCount() == 2 * t - 1) {
             this->vis->setMessage("Root is full. Growing tree height.");
             this->vis->setColor(this->root_ptr, Color::RED);
             this->vis->render();
 
             BTreeNode<T>* s = new BTreeNode<T>(t, false);
             
-            s->children[0] = r;
+            s->childPtrs()[0] = r;
             s->children_count = 1; 
             
             s->splitChild(0, r, *(this->vis));
 
             int i = 0;
-            if (s->key[0] < k) {
+            if (s->keys()[0] < k) {
                 i++;
             }
             
             this->setRoot(s);
             
-            inserted = dynamic_cast<BTreeNode<T>*>(s->children[i])->insertNonFull(k, *(this->vis));
+            if (s->keys()[0] == k) {
+                this->vis->setMessage("Key " + DataNode<T>::toString(k) + " already exists.");
+                this->vis->setColor(s, 0, Color::RED);
+                this->vis->render();
+            } else {
+                inserted = dynamic_cast<BTreeNode<T>*>(s->childPtrs()[i])->insertNonFull(k, *(this->vis));
+            }
 
         } else {
             inserted = r->insertNonFull(k, *(this->vis));
@@ -635,14 +793,18 @@ bool BTree<T>::remove(T k) {
     BTreeNode<T>* root = dynamic_cast<BTreeNode<T>*>(this->root_ptr);
     bool result = root->remove(k, *(this->vis));
 
-    if (root->key_count == 0) {
+    if (root->keyCount() == 0) {
         if (root->is_leaf_node()) {
             this->setRoot(nullptr);
         } else {
-            this->setRoot(dynamic_cast<BTreeNode<T>*>(root->children[0]));
+            this->setRoot(dynamic_cast<BTreeNode<T>*>(root->childPtrs()[0]));
         }
         delete root;
     }
+    if (result && bloom) {
+        bloom->noteRemoved();
+        if (bloom->needsRebuild()) rebuildBloom();
+    }
 
     this->vis->clear();
     if(result) this->vis->setMessage("Removal complete.");
@@ -674,4 +836,539 @@ bool BTree<T>::rangeSearch(T begin, T end) {
     }
     this->vis->render();
     return found_any;
-}
\ No newline at end of file
+}
+
+// 노드마다 x 바로 옆의 키를 후보로 잡으며 한 번만 내려간다.
+// 내부 노드에서 x와 같은 키를 만나면 답은 그 키의 predecessor/successor다.
+template <typename T>
+optional<T> BTree<T>::bound(T x, bool greater, bool inclusive) {
+    this->vis->clear();
+    this->vis->setTitle(this->boundTitle(greater, inclusive) + " of: " + DataNode<T>::toString(x));
+
+    optional<T> best;
+    BTreeNode<T>* cur = dynamic_cast<BTreeNode<T>*>(this->root_ptr);
+    while (cur != nullptr && cur->keyCount() > 0) {
+        this->stats.visited++;
+        int i = 0;
+        while (i < cur->keyCount() && cur->keys()[i] < x) i++;
+
+        this->vis->setColor(cur, Color::YELLOW);
+        this->vis->render();
+        this->vis->setColor(cur, Color::RESET);
+
+        bool leaf = cur->is_leaf_node();
+        if (i < cur->keyCount() && cur->keys()[i] == x) {
+            if (inclusive) {
+                best = x;
+            } else if (greater) {
+                if (!leaf) best = cur->getSuccessor(i);
+                else if (i + 1 < cur->keyCount()) best = cur->keys()[i + 1];
+            } else {
+                if (!leaf) best = cur->getPredecessor(i);
+                else if (i > 0) best = cur->keys()[i - 1];
+            }
+            break;
+        }
+
+        if (greater && i < cur->keyCount()) best = cur->keys()[i];
+        if (!greater && i > 0) best = cur->keys()[i - 1];
+        if (leaf) break;
+
+        this->vis->setMessage("Candidate " + (best ? DataNode<T>::toString(*best) : string("none")) +
+                              "\n-> Moving to child index " + DataNode<int>::toString(i));
+        this->vis->render();
+        cur = dynamic_cast<BTreeNode<T>*>(cur->childPtrs()[i]);
+    }
+
+    this->vis->setMessage(best ? "Result: " + DataNode<T>::toString(*best) : "No such key.");
+    this->vis->render();
+    return best;
+}
+
+// ---------------- Split / Concat ----------------
+// 루트에서 key까지 한 경로만 내려가며 각 노드를 key 왼쪽/오른쪽 조각으로 자르고,
+// 올라오면서 조각들을 joinAt(L, k, R)으로 다시 붙인다. 조각의 높이는 위로 갈수록
+// 커지므로 join 비용의 합은 O(log n)이다.
+
+template <typename T>
+bool BTree<T>::split(T key, BTree<T>& left, BTree<T>& right) {
+    this->vis->clear();
+    this->vis->setTitle("Splitting at: " + DataNode<T>::toString(key));
+
+    SubTree all = whole();
+    this->setRoot(nullptr);
+    freeSubtree(dynamic_cast<BTreeNode<T>*>(left.root_ptr));
+    freeSubtree(dynamic_cast<BTreeNode<T>*>(right.root_ptr));
+    left.setRoot(nullptr);
+    right.setRoot(nullptr);
+    left.t = right.t = t;
+    left.bloom.reset();
+    right.bloom.reset();
+    if (bloom) {
+        left.bloom.reset(new BloomFilter<T>(0, bloom->targetFpr()));
+        right.bloom.reset(new BloomFilter<T>(0, bloom->targetFpr()));
+    }
+
+    SubTree l, r;
+    bool found = false;
+    if (all.root) splitAt(all, key, l, found, r);
+    left.adopt(l);
+    right.adopt(r);
+    if (bloom) {
+        rebuildBloom();
+        left.rebuildBloom();
+        right.rebuildBloom();
+    }
+
+    this->vis->setMessage("Split Complete.");
+    this->vis->render();
+    return found;
+}
+
+template <typename T>
+bool BTree<T>::concat(BTree<T>& right) {
+    this->vis->clear();
+    this->vis->setTitle("Concatenating two trees");
+
+    if (&right == this || right.t != t) return false;
+    SubTree l = whole(), r = right.whole();
+    if (r.root == nullptr) return true;
+    if (l.root == nullptr) {
+        adopt(r);
+        right.adopt(SubTree{});
+        if (bloom) rebuildBloom();
+        if (right.bloom) right.rebuildBloom();
+        return true;
+    }
+
+    BTreeNode<T>* last = l.root;
+    while (!last->is_leaf_node()) last = dynamic_cast<BTreeNode<T>*>(last->childPtrs()[last->keyCount()]);
+    BTreeNode<T>* first = r.root;
+    while (!first->is_leaf_node()) first = dynamic_cast<BTreeNode<T>*>(first->childPtrs()[0]);
+
+    T mid = last->keys()[last->keyCount() - 1];
+    if (!(mid < first->keys()[0])) {
+        this->vis->setMessage("Keys overlap. Concat failed.");
+        this->vis->render();
+        return false;
+    }
+
+    // 가운데 키가 필요하므로 왼쪽 트리의 최댓값을 떼어 쓴다.
+    remove(mid);
+    adopt(joinAt(whole(), mid, r));
+    right.adopt(SubTree{});
+    if (bloom) rebuildBloom();
+    if (right.bloom) right.rebuildBloom();
+
+    this->vis->clear();
+    this->vis->setMessage("Concat Complete.");
+    this->vis->render();
+    return true;
+}
+
+template <typename T>
+int BTree<T>::searchFootprint(T k) {
+    vector<uintptr_t> lines;
+    auto touch = [&](const void* p) { lines.push_back(reinterpret_cast<uintptr_t>(p) / 64); };
+
+    BTreeNode<T>* x = dynamic_cast<BTreeNode<T>*>(this->root_ptr);
+    while (x != nullptr) {
+        // 노드 객체: dynamic_cast가 읽는 vptr과 블록 포인터
+        touch(x);
+        touch(&x->block);
+        touch(&x->keyCount());
+        int i = 0;
+        while (i < x->keyCount()) {
+            touch(&x->keys()[i]);
+            if (!(k > x->keys()[i])) break;
+            i++;
+        }
+        if (i < x->keyCount() && x->keys()[i] == k) break;
+        touch(&x->childPtrs()[i]);
+        x = dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]);
+    }
+
+    sort(lines.begin(), lines.end());
+    return unique(lines.begin(), lines.end()) - lines.begin();
+}
+
+// 큐에 넣는 순서가 곧 레코드 번호이므로 자식의 오프셋은 넣는 순간 정해진다.
+template <typename T>
+bool BTree<T>::saveSnapshot(const string& path) {
+    this->vis->clear();
+    this->vis->setTitle("Saving snapshot: " + path);
+
+    SnapshotWriter out(path, SnapshotKind::BTREE, sizeof(T), t, bnodeRecordSize(t, sizeof(T)));
+    vector<BTreeNode<T>*> queue;
+    if (this->root_ptr) queue.push_back(dynamic_cast<BTreeNode<T>*>(this->root_ptr));
+
+    for (size_t i = 0; i < queue.size() && out.ok(); i++) {
+        BTreeNode<T>* x = queue[i];
+        bool leaf = x->is_leaf_node();
+        out.begin();
+        out.put<uint32_t>(0, x->keyCount());
+        out.put<uint32_t>(4, leaf);
+        for (int j = 0; !leaf && j <= x->keyCount(); j++) {
+            out.put<uint64_t>(BNODE_CHILDREN_AT + 8 * j, out.offsetOf(queue.size()));
+            queue.push_back(dynamic_cast<BTreeNode<T>*>(x->childPtrs()[j]));
+        }
+        for (int j = 0; j < x->keyCount(); j++)
+            out.put<T>(bnodeKeysAt(t) + sizeof(T) * j, x->keys()[j]);
+        out.commit(x->keyCount());
+    }
+
+    bool ok = out.finish();
+    this->vis->setMessage(ok ? "Snapshot saved (" + to_string(queue.size()) + " nodes)." : "Failed to write snapshot.");
+    this->vis->render();
+    return ok;
+}
+
+template <typename T>
+typename BTree<T>::SubTree BTree<T>::whole() {
+    SubTree s{dynamic_cast<BTreeNode<T>*>(this->root_ptr), 0};
+    for (BTreeNode<T>* x = s.root; x != nullptr; x = dynamic_cast<BTreeNode<T>*>(x->childPtrs()[0]))
+        s.height++;
+    return s;
+}
+
+template <typename T>
+void BTree<T>::adopt(SubTree s) {
+    this->setRoot(s.root);
+}
+
+template <typename T>
+typename BTree<T>::SubTree BTree<T>::growIfFull(SubTree s) {
+    if (s.root->keyCount() < 2 * t - 1) return s;
+    BTreeNode<T>* root = new BTreeNode<T>(t, false);
+    root->childPtrs()[0] = s.root;
+    root->children_count = 1;
+    root->splitChild(0, s.root, *(this->vis));
+    return SubTree{root, s.height + 1};
+}
+
+// 가장 왼쪽(front) 또는 가장 오른쪽 경로로 내려가며 가득 찬 노드를 미리 나누고 리프 끝에 k를 넣는다.
+template <typename T>
+typename BTree<T>::SubTree BTree<T>::insertEdge(SubTree s, T k, bool front) {
+    if (s.root == nullptr) {
+        BTreeNode<T>* leaf = new BTreeNode<T>(t, true);
+        leaf->keys()[0] = k;
+        leaf->keyCount() = 1;
+        return SubTree{leaf, 1};
+    }
+
+    s = growIfFull(s);
+    BTreeNode<T>* x = s.root;
+    while (!x->is_leaf_node()) {
+        int i = front ? 0 : x->keyCount();
+        BTreeNode<T>* c = dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]);
+        if (c->keyCount() == 2 * t - 1) {
+            x->splitChild(i, c, *(this->vis));
+            i = front ? 0 : x->keyCount();
+        }
+        x = dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]);
+    }
+
+    if (front) {
+        for (int j = x->keyCount(); j > 0; j--) x->keys()[j] = x->keys()[j - 1];
+        x->keys()[0] = k;
+    } else {
+        x->keys()[x->keyCount()] = k;
+    }
+    x->keyCount()++;
+    return s;
+}
+
+// l의 모든 키 < k < r의 모든 키. 높은 쪽 트리의 가장자리 경로를 따라 낮은 쪽 트리의
+// 높이까지 내려가 k와 함께 자식으로 붙이고, 붙인 루트가 모자라면 옆 형제와 맞춘다.
+template <typename T>
+typename BTree<T>::SubTree BTree<T>::joinAt(SubTree l, T k, SubTree r) {
+    if (l.root == nullptr) return insertEdge(r, k, true);
+    if (r.root == nullptr) return insertEdge(l, k, false);
+
+    if (l.height == r.height) {
+        BTreeNode<T>* root = new BTreeNode<T>(t, false);
+        root->keys()[0] = k;
+        root->keyCount() = 1;
+        root->childPtrs()[0] = l.root;
+        root->childPtrs()[1] = r.root;
+        root->children_count = 2;
+        rebalancePair(root, 0);
+        if (root->keyCount() == 0) {
+            delete root;
+            return l;
+        }
+        return SubTree{root, l.height + 1};
+    }
+
+    bool attach_right = l.height > r.height;
+    SubTree tall = growIfFull(attach_right ? l : r);
+    SubTree low = attach_right ? r : l;
+
+    BTreeNode<T>* x = tall.root;
+    for (int h = tall.height; h > low.height + 1; h--) {
+        int i = attach_right ? x->keyCount() : 0;
+        BTreeNode<T>* c = dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]);
+        if (c->keyCount() == 2 * t - 1) {
+            x->splitChild(i, c, *(this->vis));
+            i = attach_right ? x->keyCount() : 0;
+        }
+        x = dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]);
+    }
+
+    if (attach_right) {
+        x->keys()[x->keyCount()] = k;
+        x->childPtrs()[x->keyCount() + 1] = low.root;
+    } else {
+        for (int j = x->keyCount(); j > 0; j--) x->keys()[j] = x->keys()[j - 1];
+        for (int j = x->keyCount() + 1; j > 0; j--) x->childPtrs()[j] = x->childPtrs()[j - 1];
+        x->keys()[0] = k;
+        x->childPtrs()[0] = low.root;
+    }
+    x->keyCount()++;
+    x->children_count = x->keyCount() + 1;
+
+    if (low.root->keyCount() < t - 1)
+        rebalancePair(x, attach_right ? x->keyCount() - 1 : 0);
+    return tall;
+}
+
+// p의 i, i+1번 자식과 그 사이 구분 키를 한 줄로 모아 한 노드에 들어가면 합치고,
+// 아니면 양쪽이 t - 1개 이상이 되도록 반씩 나눈다.
+template <typename T>
+void BTree<T>::rebalancePair(BTreeNode<T>* p, int i) {
+    BTreeNode<T>* a = dynamic_cast<BTreeNode<T>*>(p->childPtrs()[i]);
+    BTreeNode<T>* b = dynamic_cast<BTreeNode<T>*>(p->childPtrs()[i + 1]);
+    bool leaf = a->is_leaf_node();
+
+    vector<T> keys(a->keys().begin(), a->keys().begin() + a->keyCount());
+    keys.push_back(p->keys()[i]);
+    keys.insert(keys.end(), b->keys().begin(), b->keys().begin() + b->keyCount());
+    vector<DataNode<T>*> kids;
+    if (!leaf) {
+        kids.assign(a->childPtrs().begin(), a->childPtrs().begin() + a->keyCount() + 1);
+        kids.insert(kids.end(), b->childPtrs().begin(), b->childPtrs().begin() + b->keyCount() + 1);
+    }
+
+    auto fill = [&](BTreeNode<T>* node, int from, int count) {
+        for (int j = 0; j < count; j++) node->keys()[j] = keys[from + j];
+        node->keyCount() = count;
+        fill_n(node->childPtrs().begin(), node->childPtrs().size(), nullptr);
+        if (!leaf) {
+            for (int j = 0; j <= count; j++) node->childPtrs()[j] = kids[from + j];
+            node->children_count = count + 1;
+        } else {
+            node->children_count = 0;
+        }
+    };
+
+    int total = keys.size();
+    if (total <= 2 * t - 1) {
+        fill(a, 0, total);
+        delete b;
+        for (int j = i; j < p->keyCount() - 1; j++) p->keys()[j] = p->keys()[j + 1];
+        for (int j = i + 1; j < p->keyCount(); j++) p->childPtrs()[j] = p->childPtrs()[j + 1];
+        p->childPtrs()[p->keyCount()] = nullptr;
+        p->keyCount()--;
+        p->children_count = p->keyCount() + 1;
+    } else {
+        int left = total / 2;
+        fill(a, 0, left);
+        p->keys()[i] = keys[left];
+        fill(b, left + 1, total - left - 1);
+    }
+}
+
+// x의 key[from, to)와 children[from, to]만 갖는 조각. 키가 없으면 그 자식 서브트리 자체다.
+template <typename T>
+typename BTree<T>::SubTree BTree<T>::keyRange(BTreeNode<T>* x, int from, int to, int height) {
+    bool leaf = x->is_leaf_node();
+    if (from == to) {
+        if (leaf) return SubTree{};
+        return SubTree{dynamic_cast<BTreeNode<T>*>(x->childPtrs()[from]), height - 1};
+    }
+
+    BTreeNode<T>* node = new BTreeNode<T>(t, leaf);
+    for (int j = from; j < to; j++) node->keys()[j - from] = x->keys()[j];
+    node->keyCount() = to - from;
+    if (!leaf) {
+        for (int j = from; j <= to; j++) node->childPtrs()[j - from] = x->childPtrs()[j];
+        node->children_count = to - from + 1;
+    }
+    return SubTree{node, height};
+}
+
+template <typename T>
+void BTree<T>::splitAt(SubTree s, T key, SubTree& l, bool& found, SubTree& r) {
+    BTreeNode<T>* x = s.root;
+    this->stats.visited++;
+    int i = x->findKey(key);
+    int n = x->keyCount();
+
+    if (i < n && x->keys()[i] == key) {
+        found = true;
+        l = keyRange(x, 0, i, s.height);
+        SubTree rest = keyRange(x, i + 1, n, s.height);
+        delete x;
+        r = insertEdge(rest, key, true);
+        return;
+    }
+
+    if (x->is_leaf_node()) {
+        l = keyRange(x, 0, i, 1);
+        r = keyRange(x, i, n, 1);
+        delete x;
+        return;
+    }
+
+    SubTree lf, rf;
+    if (i > 0) lf = keyRange(x, 0, i - 1, s.height);
+    if (i < n) rf = keyRange(x, i + 1, n, s.height);
+    T left_mid = i > 0 ? x->keys()[i - 1] : key;
+    T right_mid = i < n ? x->keys()[i] : key;
+    SubTree child{dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]), s.height - 1};
+    delete x;
+
+    SubTree dl, dr;
+    splitAt(child, key, dl, found, dr);
+    l = i > 0 ? joinAt(lf, left_mid, dl) : dl;
+    r = i < n ? joinAt(dr, right_mid, rf) : dr;
+}
+
+template <typename T>
+void BTree<T>::setBloomFilter(bool enabled, double fpr, size_t capacity) {
+    bloom.reset();
+    if (!enabled) return;
+    bloom.reset(new BloomFilter<T>(capacity, fpr));
+    rebuildBloom();
+}
+
+template <typename T>
+void BTree<T>::rebuildBloom() {
+    vector<T> keys;
+    collectKeys(dynamic_cast<BTreeNode<T>*>(this->root_ptr), keys);
+    bloom->rebuild(keys);
+}
+
+template <typename T>
+void BTree<T>::collectKeys(BTreeNode<T>* node, vector<T>& out) {
+    if (node == nullptr) return;
+    bool leaf = node->is_leaf_node();
+    for (int i = 0; i < node->keyCount(); i++) {
+        if (!leaf) collectKeys(dynamic_cast<BTreeNode<T>*>(node->childPtrs()[i]), out);
+        out.push_back(node->keys()[i]);
+    }
+    if (!leaf) collectKeys(dynamic_cast<BTreeNode<T>*>(node->childPtrs()[node->keyCount()]), out);
+}
+
+// dynamic_cast는 자식 객체를 바로 읽어서 미리 부른 의미가 없어지므로 여기서는 static_cast로 내려간다.
+template <typename T>
+vector<bool> BTree<T>::searchBatch(const vector<T>& keys, int group) {
+    vector<bool> found(keys.size(), false);
+    if (this->root_ptr == nullptr) return found;
+    group = max(group, 1);
+    BTreeNode<T>* root = static_cast<BTreeNode<T>*>(this->root_ptr);
+    vector<BTreeNode<T>*> at(group);
+    vector<int> slot(group);
+
+    for (size_t base = 0; base < keys.size(); base += group) {
+        int g = int(min<size_t>(group, keys.size() - base));
+        int active = g;
+        for (int j = 0; j < g; j++) at[j] = root;
+        while (active > 0) {
+            for (int j = 0; j < g; j++)
+                if (at[j]) at[j]->prefetchKeys();
+            for (int j = 0; j < g; j++) {
+                BTreeNode<T>* x = at[j];
+                if (x == nullptr) continue;
+                const T& k = keys[base + j];
+                int i = 0;
+                while (i < x->keyCount() && k > x->keys()[i]) i++;
+                if (i < x->keyCount() && x->keys()[i] == k) {
+                    found[base + j] = true;
+                    at[j] = nullptr;
+                    active--;
+                    continue;
+                }
+                slot[j] = i;
+                __builtin_prefetch(&x->childPtrs()[i]);
+            }
+            for (int j = 0; j < g; j++) {
+                if (at[j] == nullptr) continue;
+                at[j] = static_cast<BTreeNode<T>*>(at[j]->childPtrs()[slot[j]]);
+                if (at[j] == nullptr) {
+                    active--;  // 리프에서 못 찾았다
+                    continue;
+                }
+                __builtin_prefetch(at[j]);
+                __builtin_prefetch(reinterpret_cast<const char*>(at[j]) + 64);
+            }
+        }
+    }
+    return found;
+}
+
+template <typename T>
+template <typename R, typename F, typename C>
+R BTree<T>::parallelRangeReduce(T begin, T end, R init, F acc, C combine, int depth) {
+    R r = init;
+    SubTree s = whole();
+    if (s.root != nullptr && !(end < begin)) reduceRange(s.root, s.height, &begin, &end, depth, r, init, acc, combine);
+    return r;
+}
+
+template <typename T>
+vector<T> BTree<T>::parallelRangeCollect(T begin, T end, int depth) {
+    return parallelRangeReduce(
+        begin, end, vector<T>(), [](vector<T>& v, const T& k) { v.push_back(k); },
+        [](vector<T> l, vector<T> r) {
+            l.insert(l.end(), r.begin(), r.end());
+            return l;
+        },
+        depth);
+}
+
+template <typename T>
+template <typename R, typename F, typename C>
+void BTree<T>::reduceRange(BTreeNode<T>* x, int height, const T* lo, const T* hi,
+                           int depth, R& r, const R& init, F& acc, C& combine) {
+    T* keys = x->keys().begin();
+    int first = lo ? lower_bound(keys, keys + x->keyCount(), *lo) - keys : 0;
+    int last = hi ? upper_bound(keys, keys + x->keyCount(), *hi) - keys : x->keyCount();
+    if (height == 1) {
+        for (int i = first; i < last; i++) acc(r, keys[i]);
+        return;
+    }
+    reduceChildren(x, height, first, last, lo, hi, depth, r, init, acc, combine);
+}
+
+template <typename T>
+template <typename R, typename F, typename C>
+void BTree<T>::reduceChildren(BTreeNode<T>* x, int height, int from, int to, const T* lo, const T* hi,
+                              int depth, R& r, const R& init, F& acc, C& combine) {
+    if (depth > 0 && height >= fork_min_height && from < to) {
+        // 왼쪽: 자식 from..mid-1과 그 사이 키, 가운데 키 mid-1, 오른쪽: 자식 mid..to와 그 사이 키
+        int mid = (from + to + 1) / 2;
+        R right = init;
+        forkJoin(depth,
+                 [&] { reduceChildren(x, height, mid, to, nullptr, hi, depth - 1, right, init, acc, combine); },
+                 [&] { reduceChildren(x, height, from, mid - 1, lo, nullptr, depth - 1, r, init, acc, combine); });
+        acc(r, x->keys()[mid - 1]);
+        r = combine(move(r), move(right));
+        return;
+    }
+    for (int i = from; i <= to; i++) {
+        reduceRange(dynamic_cast<BTreeNode<T>*>(x->childPtrs()[i]), height - 1, i == from ? lo : nullptr,
+                    i == to ? hi : nullptr, depth, r, init, acc, combine);
+        if (i < to) acc(r, x->keys()[i]);
+    }
+}
+
+template <typename T>
+void BTree<T>::freeSubtree(BTreeNode<T>* node) {
+    if (node == nullptr) return;
+    if (!node->is_leaf_node()) {
+        for (int i = 0; i <= node->keyCount(); i++)
+            freeSubtree(dynamic_cast<BTreeNode<T>*>(node->childPtrs()[i]));
+    }
+    delete node;
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// 고정 크기 페이지 파일과 그 위의 버퍼 풀.
+// 페이지 0은 풀 헤더(페이지 수, free list)와 사용자 메타 영역이 차지하고 항상 메모리에 있다.
+// 나머지 페이지는 frame에 올라온 동안 pin으로 고정되며, pin이 0인 frame만 CLOCK으로 교체된다.
+// 파일 I/O가 실패하면 runtime_error를 던진다.
+
+using PageId = uint32_t;
+const PageId INVALID_PAGE = 0;
+
+class BufferPool;
+
+// pin된 페이지 하나. 소멸되거나 다른 페이지를 대입받으면 unpin한다.
+class PageRef {
+public:
+    PageRef() {}
+    PageRef(BufferPool* pool, int frame, PageId id, char* data) : pool(pool), frame(frame), page(id), bytes(data) {}
+    PageRef(PageRef&& other) noexcept { take(other); }
+    PageRef& operator=(PageRef&& other) noexcept {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+    PageRef(const PageRef&) = delete;
+    PageRef& operator=(const PageRef&) = delete;
+    ~PageRef() { release(); }
+
+    PageId id() const { return page; }
+    char* data() const { return bytes; }
+    void markDirty() { dirty = true; }
+    explicit operator bool() const { return bytes != nullptr; }
+
+    inline void release();
+
+private:
+    BufferPool* pool = nullptr;
+    int frame = -1;
+    PageId page = INVALID_PAGE;
+    char* bytes = nullptr;
+    bool dirty = false;
+
+    void take(PageRef& other) {
+        pool = other.pool;
+        frame = other.frame;
+        page = other.page;
+        bytes = other.bytes;
+        dirty = other.dirty;
+        other.pool = nullptr;
+        other.bytes = nullptr;
+        other.dirty = false;
+    }
+};
+
+class BufferPool {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;    // pread한 페이지 수
+        uint64_t writes = 0;    // pwrite한 페이지 수
+        uint64_t evictions = 0;
+    };
+
+    // 페이지 0 앞부분. 그 뒤(META_OFFSET부터)는 사용자 메타 영역이다.
+    static const size_t META_OFFSET = 64;
+
+    // path가 없거나 truncate면 새 파일을 만든다. 기존 파일은 페이지 크기가 같아야 한다.
+    BufferPool(const string& path, uint32_t page_size, size_t frame_count, bool truncate = false)
+        : page_size(page_size), memory(page_size * frame_count), frames(frame_count), header_page(page_size, 0) {
+        if (page_size < 512 || frame_count < 4) throw runtime_error("BufferPool: page size >= 512 and 4+ frames required");
+
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+        if (fd < 0) throw runtime_error("BufferPool: cannot open " + path);
+
+        struct stat st;
+        fstat(fd, &st);
+        if (st.st_size == 0) {
+            created = true;
+            memcpy(header_page.data(), "TVIZPAGE", 8);
+            setHeader(8, page_size);
+            setHeader(12, 1u);  // 페이지 0
+            setHeader(16, INVALID_PAGE);
+            header_dirty = true;
+        } else {
+            readPage(0, header_page.data());
+            if (memcmp(header_page.data(), "TVIZPAGE", 8) != 0 || getHeader(8) != page_size) {
+                ::close(fd);
+                throw runtime_error("BufferPool: " + path + " is not a page file with page size " + to_string(page_size));
+            }
+        }
+    }
+
+    ~BufferPool() {
+        try {
+            flush();
+        } catch (...) {
+        }
+        ::close(fd);
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    uint32_t pageSize() const { return page_size; }
+    bool isNewFile() const { return created; }
+    uint32_t pageCount() const { return getHeader(12); }
+
+    const char* meta() const { return header_page.data() + META_OFFSET; }
+    void setMeta(const void* bytes, size_t n) {
+        if (n > page_size - META_OFFSET) throw runtime_error("BufferPool: meta does not fit in page 0");
+        memcpy(header_page.data() + META_OFFSET, bytes, n);
+        header_dirty = true;
+    }
+
+    PageRef fetch(PageId id) {
+        if (id == INVALID_PAGE || id >= pageCount()) throw runtime_error("BufferPool: bad page id " + to_string(id));
+        auto it = table.find(id);
+        if (it != table.end()) {
+            stats.hits++;
+            return pin(it->second);
+        }
+        stats.misses++;
+        int f = victim();
+        readPage(id, frameData(f));
+        install(f, id);
+        return pin(f);
+    }
+
+    // free list에서 꺼내거나 파일 끝에 새 페이지를 붙인다. 내용은 0으로 채워진다.
+    PageRef allocate() {
+        PageId id = getHeader(16);
+        if (id != INVALID_PAGE) {
+            PageRef page = fetch(id);
+            uint32_t next;
+            memcpy(&next, page.data(), sizeof(next));
+            setHeader(16, next);
+            memset(page.data(), 0, page_size);
+            page.markDirty();
+            return page;
+        }
+        id = pageCount();
+        setHeader(12, id + 1);
+        int f = victim();
+        memset(frameData(f), 0, page_size);
+        install(f, id);
+        frames[f].dirty = true;
+        return pin(f);
+    }
+
+    // 다시 쓸 수 있도록 free list에 넣는다. 페이지의 첫 4바이트가 다음 free 페이지 번호가 된다.
+    void release(PageId id) {
+        PageRef page = fetch(id);
+        uint32_t next = getHeader(16);
+        memcpy(page.data(), &next, sizeof(next));
+        page.markDirty();
+        setHeader(16, id);
+    }
+
+    // dirty frame과 헤더를 쓰고 fdatasync한다.
+    void flush() {
+        bool wrote = false;
+        for (size_t f = 0; f < frames.size(); f++) {
+            if (frames[f].dirty) {
+                writePage(frames[f].id, frameData(f));
+                frames[f].dirty = false;
+                wrote = true;
+            }
+        }
+        if (header_dirty) {
+            writePage(0, header_page.data());
+            header_dirty = false;
+            wrote = true;
+        }
+        if (wrote && fdatasync(fd) != 0) throw runtime_error("BufferPool: fdatasync failed");
+    }
+
+    Stats getStats() const { return stats; }
+    void resetStats() { stats = Stats{}; }
+
+private:
+    struct Frame {
+        PageId id = INVALID_PAGE;
+        int pins = 0;
+        bool dirty = false;
+        bool referenced = false;
+    };
+
+    int fd = -1;
+    uint32_t page_size;
+    vector<char> memory;
+    vector<Frame> frames;
+    unordered_map<PageId, int> table;
+    size_t hand = 0;  // CLOCK 바늘
+    vector<char> header_page;
+    bool header_dirty = false;
+    bool created = false;
+    Stats stats;
+
+    friend class PageRef;
+
+    char* frameData(size_t f) { return memory.data() + f * page_size; }
+
+    uint32_t getHeader(size_t at) const {
+        uint32_t v;
+        memcpy(&v, header_page.data() + at, sizeof(v));
+        return v;
+    }
+    void setHeader(size_t at, uint32_t v) {
+        memcpy(header_page.data() + at, &v, sizeof(v));
+        header_dirty = true;
+    }
+
+    PageRef pin(int f) {
+        frames[f].pins++;
+        frames[f].referenced = true;
+        return PageRef(this, f, frames[f].id, frameData(f));
+    }
+
+    void unpin(int f, bool dirty) {
+        frames[f].pins--;
+        frames[f].dirty |= dirty;
+    }
+
+    void install(int f, PageId id) {
+        frames[f].id = id;
+        frames[f].dirty = false;
+        table[id] = f;
+    }
+
+    // 빈 frame이 있으면 그것을, 없으면 CLOCK으로 참조 비트가 꺼진 unpin frame을 고른다.
+    // 두 바퀴를 돌아도 못 찾으면 모든 frame이 pin된 것이다.
+    int victim() {
+        for (size_t step = 0; step < 2 * frames.size(); step++) {
+            size_t f = hand;
+            hand = (hand + 1) % frames.size();
+            Frame& fr = frames[f];
+            if (fr.id == INVALID_PAGE) return f;
+            if (fr.pins > 0) continue;
+            if (fr.referenced) {
+                fr.referenced = false;
+                continue;
+            }
+            if (fr.dirty) writePage(fr.id, frameData(f));
+            table.erase(fr.id);
+            fr = Frame{};
+            stats.evictions++;
+            return f;
+        }
+        throw runtime_error("BufferPool: all frames are pinned");
+    }
+
+    void readPage(PageId id, char* out) {
+        size_t done = 0;
+        off_t base = (off_t)id * page_size;
+        while (done < page_size) {
+            ssize_t n = pread(fd, out + done, page_size - done, base + done);
+            if (n < 0) throw runtime_error("BufferPool: pread failed on page " + to_string(id));
+            if (n == 0) {
+                memset(out + done, 0, page_size - done);
+                break;
+            }
+            done += n;
+        }
+    }
+
+    void writePage(PageId id, const char* in) {
+        size_t done = 0;
+        off_t base = (off_t)id * page_size;
+        while (done < page_size) {
+            ssize_t n = pwrite(fd, in + done, page_size - done, base + done);
+            if (n <= 0) throw runtime_error("BufferPool: pwrite failed on page " + to_string(id));
+            done += n;
+        }
+        stats.writes++;
+    }
+};
+
+inline void PageRef::release() {
+    if (pool && bytes) pool->unpin(frame, dirty);
+    pool = nullptr;
+    bytes = nullptr;
+    dirty = false;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include "snapshot.hpp"
+#include "wal.hpp"
+
+using namespace std;
+
+// 스냅샷 + WAL로 장애 후에도 내용을 되살리는 트리 래퍼.
+// TreeT는 saveSnapshot()이 있는 트리(BTree, BPlusTree, RBTree)다.
+//   <prefix>.snap : 마지막 체크포인트의 스냅샷
+//   <prefix>.wal  : 그 뒤의 insert/remove 기록
+// 생성할 때 스냅샷을 읽어 트리를 만들고 로그를 다시 적용한다.
+// insert/remove는 로그에 먼저 쓰고 트리를 고친다.
+//
+// 체크포인트가 스냅샷을 바꾼 뒤 로그를 비우기 전에 죽으면 옛 로그가 새 스냅샷 위에 다시 적용된다.
+// 집합의 insert/remove는 키마다 마지막 연산이 결과를 정하므로 같은 로그를 두 번 적용해도 결과가 같다.
+template <typename TreeT, typename T>
+class DurableTree {
+public:
+    template <typename... Args>
+    DurableTree(const string& prefix, Args&&... tree_args)
+        : tree_(std::forward<Args>(tree_args)...), snap_path(prefix + ".snap"), log(prefix + ".wal") {
+        recover();
+    }
+
+    TreeT& tree() { return tree_; }
+    WriteAheadLog<T>& wal() { return log; }
+
+    bool search(T k) { return tree_.search(k); }
+
+    bool insert(T k) {
+        uint64_t lsn = log.append(WriteAheadLog<T>::INSERT, k);
+        if (afterLog) afterLog(lsn);
+        return tree_.insert(k);
+    }
+
+    bool remove(T k) {
+        uint64_t lsn = log.append(WriteAheadLog<T>::REMOVE, k);
+        if (afterLog) afterLog(lsn);
+        return tree_.remove(k);
+    }
+
+    // 트리 전체를 스냅샷으로 남기고 로그를 비운다.
+    // 임시 파일에 쓰고 fsync한 뒤 rename하므로 도중에 죽어도 이전 스냅샷이 남는다.
+    void checkpoint() {
+        log.sync();
+        string tmp = snap_path + ".tmp";
+        if (!tree_.saveSnapshot(tmp)) throw runtime_error("DurableTree: cannot write " + tmp);
+        int fd = ::open(tmp.c_str(), O_RDONLY);
+        bool synced = fd >= 0 && fsync(fd) == 0;
+        if (fd >= 0) ::close(fd);
+        if (!synced || rename(tmp.c_str(), snap_path.c_str()) != 0)
+            throw runtime_error("DurableTree: cannot install " + snap_path);
+        log.reset();
+    }
+
+    uint64_t getSnapshotKeys() const { return snapshot_keys; }
+    uint64_t getReplayedRecords() const { return replayed; }
+
+    // 로그에 쓴 직후, 트리를 고치기 전에 불린다 (장애 주입용).
+    function<void(uint64_t lsn)> afterLog;
+
+private:
+    TreeT tree_;
+    string snap_path;
+    WriteAheadLog<T> log;
+    uint64_t snapshot_keys = 0;
+    uint64_t replayed = 0;
+
+    void recover() {
+        SnapshotView<T> view;
+        if (view.open(snap_path)) {
+            snapshot_keys = view.size();
+            view.forEach([&](T k) { tree_.insert(k); });
+        }
+        replayed = log.replay([&](typename WriteAheadLog<T>::Op op, T k) {
+            if (op == WriteAheadLog<T>::INSERT) tree_.insert(k);
+            else tree_.remove(k);
+        });
+    }
+};
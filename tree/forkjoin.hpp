@@ -0,0 +1,28 @@
+#pragma once
+#include <future>
+#include <thread>
+#include <utility>
+
+// 재귀 분할 정복용 fork-join.
+// depth가 남아 있으면 a를 새 스레드로 fork하고 b는 현재 스레드에서 실행한 뒤 join한다.
+// 재귀할 때마다 depth를 1씩 줄여 넘기면 동시에 도는 스레드는 최대 2^depth개다.
+// 빌드: std::async를 쓰므로 오래된 glibc에서는 -pthread가 필요하다.
+template <typename A, typename B>
+void forkJoin(int depth, A&& a, B&& b) {
+    if (depth <= 0) {
+        a();
+        b();
+        return;
+    }
+    auto forked = std::async(std::launch::async, std::forward<A>(a));
+    b();
+    forked.get();
+}
+
+// 코어 수를 채울 만큼의 fork 깊이. 양쪽 작업 크기가 고르지 않으므로 한 단계 더 쪼갠다.
+inline int defaultForkDepth() {
+    unsigned cores = std::thread::hardware_concurrency();
+    int depth = 0;
+    while ((1u << depth) < cores) depth++;
+    return depth + 1;
+}
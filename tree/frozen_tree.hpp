@@ -0,0 +1,135 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include "tree.hpp"
+
+using namespace std;
+
+// 한 번 만들고 읽기만 하는 인덱스용 불변 배열 트리.
+// 정렬된 키를 포인터 없이 implicit 배열에 배치하고, 자식 위치는 인덱스 계산으로 구한다.
+//   EYTZINGER : BFS 순서 이진 트리. 노드 k의 자식은 2k, 2k+1 (1부터 시작)
+//   BLOCKED   : 캐시 라인 하나(BLOCK개 키)를 노드로 하는 (BLOCK+1)-진 트리. 블록 k의 j번째 자식은 k*(BLOCK+1)+j+1
+// 두 배치 모두 하강 중에 분기하지 않는다 (비교 결과를 그대로 인덱스에 더한다).
+// Eytzinger는 몇 레벨 아래 자손들이 한 캐시 라인에 모여 있으므로 그 라인을 미리 prefetch한다.
+template <typename T>
+class FrozenTree {
+public:
+    enum Layout { EYTZINGER, BLOCKED };
+
+    // 블록 하나에 들어가는 키 수 (64바이트 라인 하나)
+    static constexpr int BLOCK = sizeof(T) >= 64 ? 1 : int(64 / sizeof(T));
+
+    // sorted는 중복 없이 오름차순이어야 한다.
+    explicit FrozenTree(const vector<T>& sorted, Layout layout = EYTZINGER) : n(sorted.size()), layout_(layout) {
+        if (layout == EYTZINGER) {
+            allocate(n + 1);
+            size_t i = 0;
+            fillEytzinger(sorted, i, 1);
+        } else {
+            blocks = (n + BLOCK - 1) / BLOCK;
+            allocate(blocks * BLOCK);
+            size_t i = 0;
+            fillBlocked(sorted, i, 0);
+        }
+    }
+
+    FrozenTree(FrozenTree&&) = default;
+    FrozenTree& operator=(FrozenTree&&) = default;
+    FrozenTree(const FrozenTree&) = delete;
+    FrozenTree& operator=(const FrozenTree&) = delete;
+
+    bool search(T k) const {
+        const T* found = find(k);
+        return found != nullptr && !(k < *found);
+    }
+
+    // k 이상인 최소 키
+    optional<T> lowerBound(T k) const {
+        const T* found = find(k);
+        if (found == nullptr) return nullopt;
+        return *found;
+    }
+
+    size_t size() const { return n; }
+    Layout layout() const { return layout_; }
+    size_t bytes() const { return storage.size() * sizeof(T); }
+
+private:
+    // 이만큼 떨어진 인덱스가 몇 레벨 아래 자손들이 모인 캐시 라인의 시작이다 (2의 거듭제곱)
+    static constexpr size_t PREFETCH_STRIDE = BLOCK >= 16 ? 16 : BLOCK >= 8 ? 8 : BLOCK >= 4 ? 4 : BLOCK >= 2 ? 2 : 1;
+
+    vector<T> storage;
+    T* slots = nullptr;  // storage 안의 64바이트 정렬된 시작 위치
+    size_t n;
+    size_t blocks = 0;
+    Layout layout_;
+
+    // 배열 시작을 라인 경계에 맞춘다. 그래야 Eytzinger의 k*STRIDE ~ k*STRIDE+STRIDE-1이 라인 하나에,
+    // BLOCKED의 블록 하나가 라인 하나에 들어간다.
+    void allocate(size_t count) {
+        size_t pad = 64 % sizeof(T) == 0 ? 64 / sizeof(T) : 0;
+        storage.resize(count + pad);
+        size_t off = 0;
+        while (off < pad && reinterpret_cast<uintptr_t>(storage.data() + off) % 64 != 0) off++;
+        slots = storage.data() + (off < pad ? off : 0);
+    }
+
+    void fillEytzinger(const vector<T>& sorted, size_t& i, size_t k) {
+        if (k > n) return;
+        fillEytzinger(sorted, i, 2 * k);
+        slots[k] = sorted[i++];
+        fillEytzinger(sorted, i, 2 * k + 1);
+    }
+
+    // 마지막 블록의 남는 칸은 최댓값으로 채운다. 남는 칸은 중위 순서상 맨 뒤이므로 결과가 바뀌지 않는다.
+    void fillBlocked(const vector<T>& sorted, size_t& i, size_t k) {
+        if (k >= blocks) return;
+        for (int j = 0; j < BLOCK; j++) {
+            fillBlocked(sorted, i, k * (BLOCK + 1) + j + 1);
+            slots[k * BLOCK + j] = i < n ? sorted[i++] : sorted[n - 1];
+        }
+        fillBlocked(sorted, i, k * (BLOCK + 1) + BLOCK + 1);
+    }
+
+    const T* find(T k) const { return layout_ == EYTZINGER ? findEytzinger(k) : findBlocked(k); }
+
+    // 내려간 경로를 비트로 기록하다가(오른쪽 = 1) 마지막으로 왼쪽으로 간 곳까지 되돌아간다.
+    const T* findEytzinger(T k) const {
+        size_t i = 1;
+        while (i <= n) {
+            __builtin_prefetch(slots + i * PREFETCH_STRIDE);
+            i = 2 * i + (slots[i] < k);
+        }
+        i >>= __builtin_ffsll(~i);
+        return i == 0 ? nullptr : slots + i;
+    }
+
+    // 블록 안에서 k보다 작은 키 수 j를 세고(고정 길이라 벡터화된다), j번째 자식으로 내려간다.
+    // j < BLOCK이면 블록의 j번째 키가 지금까지의 가장 가까운 후보다.
+    const T* findBlocked(T k) const {
+        const T* best = nullptr;
+        size_t b = 0;
+        while (b < blocks) {
+            const T* block = slots + b * BLOCK;
+            int j = 0;
+            for (int s = 0; s < BLOCK; s++) j += block[s] < k;
+            best = j < BLOCK ? block + j : best;
+            b = b * (BLOCK + 1) + j + 1;
+        }
+        return best;
+    }
+};
+
+// 어떤 DataTree든 키를 오름차순으로 모아 FrozenTree로 만든다. 원래 트리는 바뀌지 않는다.
+// 키는 트리의 predecessor/successor로 모으므로 (T{}를 기준으로 양쪽으로) 키 하나에 하강 한 번이 든다.
+// 모으는 동안 트리의 시각화가 켜져 있으면 그대로 그려지므로 보통은 끄고 부른다.
+template <typename T>
+FrozenTree<T> freeze(DataTree<T>& tree, typename FrozenTree<T>::Layout layout = FrozenTree<T>::EYTZINGER) {
+    vector<T> keys;
+    for (optional<T> k = tree.predecessor(T{}); k; k = tree.predecessor(*k)) keys.push_back(*k);
+    reverse(keys.begin(), keys.end());
+    for (optional<T> k = tree.lowerBound(T{}); k; k = tree.successor(*k)) keys.push_back(*k);
+    return FrozenTree<T>(keys, layout);
+}
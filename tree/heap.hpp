@@ -0,0 +1,217 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+// 배열 기반(implicit) d-ary 힙.
+// i번 노드의 자식은 D*i+1 ~ D*i+D 에 연속으로 놓이므로, D=4/8이면
+// 한 번의 sift-down에서 비교하는 형제들이 같은 캐시 라인에 모인다.
+// Compare가 less<T>이면 top()이 가장 작은 값인 min-heap이다.
+template <typename T, int D = 4, typename Compare = less<T>>
+class DaryHeap {
+    static_assert(D >= 2, "DaryHeap needs at least 2 children per node");
+
+public:
+    // handle = (세대 << 32) | 슬롯. pop된 값의 슬롯은 세대를 하나 올려 free list에 넣고 다음 push가 다시 쓴다.
+    // 그래서 슬롯 표는 push 누적 횟수가 아니라 동시에 들어 있던 최대 원소 수만큼만 자라고,
+    // pop된 값의 handle은 슬롯이 재사용되어도 세대가 달라 contains/decreaseKey가 거부한다.
+    // (세대는 32비트라 한 슬롯이 2^32번 재사용되면 한 바퀴 돈다.)
+    using Handle = uint64_t;
+
+    DaryHeap(Compare cmp = Compare{}) : cmp(cmp) {}
+
+    bool empty() const { return data.empty(); }
+    int size() const { return data.size(); }
+    const T& top() const { return data[0]; }
+
+    // 반환된 handle은 값이 pop될 때까지 decreaseKey에 쓸 수 있다.
+    Handle push(T value) {
+        int s;
+        if (free_slots.empty()) {
+            s = pos_of.size();
+            pos_of.push_back(data.size());
+            generation.push_back(0);
+        } else {
+            s = free_slots.back();
+            free_slots.pop_back();
+            pos_of[s] = data.size();
+        }
+        data.push_back(move(value));
+        slot_at.push_back(s);
+        siftUp(data.size() - 1);
+        return makeHandle(s);
+    }
+
+    bool pop(T& out) {
+        if (data.empty()) return false;
+        out = move(data[0]);
+        retire(slot_at[0]);
+
+        int last = data.size() - 1;
+        if (last > 0) {
+            data[0] = move(data[last]);
+            slot_at[0] = slot_at[last];
+            pos_of[slot_at[0]] = 0;
+        }
+        data.pop_back();
+        slot_at.pop_back();
+        if (!data.empty()) siftDown(0);
+        return true;
+    }
+
+    // 값을 top 쪽으로 당긴다 (min-heap이면 더 작은 값으로만 갱신 가능).
+    bool decreaseKey(Handle h, T value) {
+        int s = liveSlot(h);
+        if (s < 0) return false;
+        int i = pos_of[s];
+        if (cmp(data[i], value)) return false;
+        data[i] = move(value);
+        siftUp(i);
+        return true;
+    }
+
+    bool contains(Handle h) const { return liveSlot(h) >= 0; }
+
+    // 기존 내용을 버리고 values로 O(n) 힙을 만든다. 반환값의 i번째가 values[i]의 handle이다.
+    // 이전 handle은 모두 무효가 된다.
+    vector<Handle> heapify(vector<T> values) {
+        data = move(values);
+        int n = data.size();
+        resetSlots(n);
+        slot_at.resize(n);
+        vector<Handle> handles(n);
+        for (int i = 0; i < n; i++) {
+            slot_at[i] = i;
+            pos_of[i] = i;
+            handles[i] = makeHandle(i);
+        }
+        for (int i = n < 2 ? -1 : parentOf(n - 1); i >= 0; i--)
+            siftDown(i);
+        return handles;
+    }
+
+    // 이전 handle은 모두 무효가 된다. 슬롯 표는 남겨 두고 다시 쓴다.
+    void clear() {
+        data.clear();
+        slot_at.clear();
+        resetSlots(0);
+    }
+
+    // 지금까지 만든 슬롯 수 (handle 표 크기)
+    int handleCapacity() const { return pos_of.size(); }
+
+private:
+    vector<T> data;
+    vector<int> slot_at;        // 위치 -> 슬롯
+    vector<int> pos_of;         // 슬롯 -> 위치 (비어 있으면 -1)
+    vector<uint32_t> generation; // 슬롯 -> 세대 (비울 때마다 증가)
+    vector<int> free_slots;     // 비어 있어 다시 쓸 수 있는 슬롯
+    Compare cmp;
+
+    Handle makeHandle(int s) const { return Handle(generation[s]) << 32 | uint32_t(s); }
+
+    // h가 가리키는 값이 아직 힙에 있으면 그 슬롯, 아니면 -1
+    int liveSlot(Handle h) const {
+        size_t s = uint32_t(h);
+        if (s >= pos_of.size() || pos_of[s] < 0 || generation[s] != uint32_t(h >> 32)) return -1;
+        return s;
+    }
+
+    void retire(int s) {
+        pos_of[s] = -1;
+        generation[s]++;
+        free_slots.push_back(s);
+    }
+
+    // 들어 있던 슬롯을 모두 비우고, 슬롯 0..n-1을 새로 쓸 수 있게 표를 맞춘다.
+    void resetSlots(int n) {
+        for (size_t s = 0; s < pos_of.size(); s++)
+            if (pos_of[s] >= 0) {
+                pos_of[s] = -1;
+                generation[s]++;
+            }
+        if ((int)pos_of.size() < n) {
+            pos_of.resize(n, -1);
+            generation.resize(n, 0);
+        }
+        free_slots.clear();
+        for (int s = pos_of.size() - 1; s >= n; s--) free_slots.push_back(s);
+    }
+
+    static int parentOf(int i) { return (i - 1) / D; }
+
+    void place(int i, T&& value, int s) {
+        data[i] = move(value);
+        slot_at[i] = s;
+        pos_of[s] = i;
+    }
+
+    // 빈 칸을 위로 옮기며 값을 한 번만 기록한다 (swap 대신 hole 이동).
+    void siftUp(int i) {
+        T value = move(data[i]);
+        int s = slot_at[i];
+        while (i > 0) {
+            int p = parentOf(i);
+            if (!cmp(value, data[p])) break;
+            place(i, move(data[p]), slot_at[p]);
+            i = p;
+        }
+        place(i, move(value), s);
+    }
+
+    void siftDown(int i) {
+        int n = data.size();
+        T value = move(data[i]);
+        int s = slot_at[i];
+        while (true) {
+            int first = D * i + 1;
+            if (first >= n) break;
+            int last = first + D < n ? first + D : n;
+
+            int best = first;
+            for (int c = first + 1; c < last; c++)
+                if (cmp(data[c], data[best])) best = c;
+
+            if (!cmp(data[best], value)) break;
+            place(i, move(data[best]), slot_at[best]);
+            i = best;
+        }
+        place(i, move(value), s);
+    }
+};
+
+// d-ary max-heap을 배열 자체에 만들어 오름차순으로 제자리 정렬한다.
+template <int D = 4, typename T, typename Compare = less<T>>
+void heapSort(vector<T>& a, Compare cmp = Compare{}) {
+    static_assert(D >= 2, "heapSort needs at least 2 children per node");
+
+    auto siftDown = [&](int i, int n) {
+        T value = move(a[i]);
+        while (true) {
+            int first = D * i + 1;
+            if (first >= n) break;
+            int last = first + D < n ? first + D : n;
+
+            int best = first;
+            for (int c = first + 1; c < last; c++)
+                if (cmp(a[best], a[c])) best = c;
+
+            if (!cmp(value, a[best])) break;
+            a[i] = move(a[best]);
+            i = best;
+        }
+        a[i] = move(value);
+    };
+
+    int n = a.size();
+    if (n < 2) return;
+    for (int i = (n - 2) / D; i >= 0; i--)
+        siftDown(i, n);
+    for (int end = n - 1; end > 0; end--) {
+        swap(a[0], a[end]);
+        siftDown(0, end);
+    }
+}
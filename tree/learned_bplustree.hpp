@@ -0,0 +1,284 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+#include "bplustree.hpp"
+
+using namespace std;
+
+// 리프 위에 학습된 모델을 얹은 B+ 트리 (숫자 키 전용).
+// 리프마다 하한 키 low(리프의 첫 키)를 모은 디렉터리를 두고, low -> 디렉터리 위치를
+// 오차 error 이내로 맞히는 구간별 선형 모델(segment)로 예측한다.
+// search/lowerBound는 내부 노드를 거치지 않고 예측 위치 ± 오차 창에서만 이분 탐색해 리프를 찾는다.
+//   low[i-1]의 리프 최댓값 < low[i] <= 리프 i의 최솟값 이므로 키 k의 리프는 low <= k인 마지막 리프다.
+//
+// insert/remove는 기존 B+ 구조에 그대로 하고, 바뀐 리프 몇 개만 디렉터리에서 고친다.
+// 한 번 고칠 때마다 그 segment의 오차가 최대 1 늘어나므로 extra로 세어 창을 넓히고,
+// extra가 error를 넘으면 그 segment와 양옆만 다시 학습한다. 학습할 때 segment 길이는 MAX_SEGMENT 이하로 자르고
+// 고치는 동안 두 배까지 자라게 두어, 재학습 비용을 제한하면서도 꽉 찬 segment가 삽입마다 다시 학습되지 않게 한다.
+// split/concat은 지원하지 않는다. compact는 리프를 다시 쌓을 수 있으므로 끝나면 전체를 다시 학습한다.
+template <typename T>
+class LearnedBPlusTree : public BPlusTree<T> {
+    static_assert(is_arithmetic<T>::value, "LearnedBPlusTree needs a numeric key type");
+
+public:
+    static const int MAX_SEGMENT = 1024;
+
+    explicit LearnedBPlusTree(int _t, int error = 8) : BPlusTree<T>(_t), error(max(error, 1)) {}
+
+    bool search(T k) override;
+    bool insert(T k) override;
+    bool remove(T k) override;
+
+    void setLazyDelete(bool enabled, double ratio = 0.25) {
+        BPlusTree<T>::setLazyDelete(enabled, ratio);
+        train();
+    }
+    void compact() {
+        BPlusTree<T>::compact();
+        train();
+    }
+    void bulkLoad(const vector<T>& keys) {
+        BPlusTree<T>::bulkLoad(keys);
+        train();
+    }
+    int removeRange(T begin, T end) {
+        int removed = BPlusTree<T>::removeRange(begin, end);
+        train();
+        return removed;
+    }
+
+    bool split(T key, BPlusTree<T>& left, BPlusTree<T>& right) = delete;
+    bool concat(BPlusTree<T>& right) = delete;
+
+    int getSegmentCount() const { return segments.size(); }
+    int getLeafCount() const { return dir.size(); }
+    long long getRetrainCount() const { return retrains; }
+
+    // 리프 디렉터리와 모델을 처음부터 다시 만든다.
+    void train();
+
+protected:
+    optional<T> bound(T x, bool greater, bool inclusive) override;
+
+private:
+    struct Entry {
+        T low;
+        BPlusTreeNode<T>* leaf;
+        bool operator==(const Entry& o) const { return low == o.low && leaf == o.leaf; }
+    };
+
+    // 디렉터리 [start, end)를 덮는 선형 모델. 위치 = start + slope * (k - anchor)
+    struct Segment {
+        T first;   // dir[start].low. 어느 segment인지 고를 때 쓴다.
+        T anchor;  // 학습할 때의 첫 키
+        double slope;
+        int start, end;
+        int extra = 0;  // 학습 뒤 고친 횟수 (오차 증가분)
+    };
+
+    int error;
+    vector<Entry> dir;
+    vector<Segment> segments;
+    long long retrains = 0;
+
+    int locate(T k) const;
+    void fit(int from, int to, vector<Segment>& out) const;
+    void refresh(int a, int b);
+    static Entry entryOf(BPlusTreeNode<T>* leaf) { return Entry{leaf->key[0], leaf}; }
+};
+
+// ---------------- Model ----------------
+
+// 리프 체인을 따라 디렉터리를 만들고 전체를 학습한다.
+template <typename T>
+void LearnedBPlusTree<T>::train() {
+    dir.clear();
+    segments.clear();
+    if (this->root_ptr) {
+        for (BPlusTreeNode<T>* leaf = BPlusTree<T>::edgeLeaf(dynamic_cast<BPlusTreeNode<T>*>(this->root_ptr), false);
+             leaf; leaf = leaf->next)
+            if (leaf->key_count > 0) dir.push_back(entryOf(leaf));
+    }
+    fit(0, dir.size(), segments);
+    retrains++;
+}
+
+// shrinking cone: segment 첫 점을 지나는 직선 중 이후 모든 점을 ± error 안에 두는 기울기 범위를
+// 좁혀 가다가 비면 새 segment를 시작한다. 기울기는 0 이상으로 둔다 (범위 밖 키의 예측이 끝으로 가도록).
+template <typename T>
+void LearnedBPlusTree<T>::fit(int from, int to, vector<Segment>& out) const {
+    int s = from;
+    while (s < to) {
+        double x0 = double(dir[s].low);
+        double lo = 0, hi = HUGE_VAL;
+        int e = s + 1;
+        for (; e < to && e - s < MAX_SEGMENT; e++) {
+            double dx = double(dir[e].low) - x0, dy = e - s;
+            if (dx <= 0) break;  // double로 구분되지 않는 키
+            double nlo = max(lo, (dy - error) / dx), nhi = min(hi, (dy + error) / dx);
+            if (nlo > nhi) break;
+            lo = nlo;
+            hi = nhi;
+        }
+        double slope = hi == HUGE_VAL ? 0 : (lo + hi) / 2;
+        out.push_back(Segment{dir[s].low, dir[s].low, slope, s, e});
+        s = e;
+    }
+}
+
+// low <= k인 마지막 디렉터리 위치 (k가 첫 low보다 작으면 0). 비었으면 -1.
+template <typename T>
+int LearnedBPlusTree<T>::locate(T k) const {
+    if (dir.empty()) return -1;
+    auto it = upper_bound(segments.begin(), segments.end(), k, [](T x, const Segment& s) { return x < s.first; });
+    const Segment& s = it == segments.begin() ? *it : *(it - 1);
+
+    double p = s.start + s.slope * (double(k) - double(s.anchor));
+    int pos = p <= s.start ? s.start : p >= s.end - 1 ? s.end - 1 : int(p + 0.5);
+    int window = error + s.extra + 1;
+    int lo = max(s.start, pos - window), hi = min(s.end, pos + window + 1);
+
+    auto before = [](T x, const Entry& e) { return x < e.low; };
+    int idx = upper_bound(dir.begin() + lo, dir.begin() + hi, k, before) - dir.begin() - 1;
+    // 오차 범위 밖이면 (일어나지 않아야 한다) 전체에서 찾는다.
+    if ((idx < lo && lo > 0) || (hi < (int)dir.size() && !(k < dir[hi].low)))
+        idx = upper_bound(dir.begin(), dir.end(), k, before) - dir.begin() - 1;
+    return max(idx, 0);
+}
+
+// dir[a]의 리프부터 dir[b]의 리프 직전까지 리프 체인을 다시 읽어 디렉터리를 고친다.
+// dir[a]와 dir[b]는 연산 중 사라지지 않은 리프여야 한다.
+// 앞뒤로 같은 항목을 잘라 실제로 바뀐 부분만 segment에 반영한다.
+template <typename T>
+void LearnedBPlusTree<T>::refresh(int a, int b) {
+    BPlusTreeNode<T>* stop = b < (int)dir.size() ? dir[b].leaf : nullptr;
+    vector<Entry> now;
+    for (BPlusTreeNode<T>* leaf = dir[a].leaf; leaf != stop; leaf = leaf->next)
+        if (leaf->key_count > 0) now.push_back(entryOf(leaf));
+
+    int head = 0, tail = 0;
+    while (head < (int)now.size() && a + head < b && now[head] == dir[a + head]) head++;
+    while (tail < (int)now.size() - head && b - tail > a + head && now[now.size() - 1 - tail] == dir[b - 1 - tail]) tail++;
+    int from = a + head, to = b - tail;
+    vector<Entry> changed(now.begin() + head, now.end() - tail);
+    if (from == to && changed.empty()) return;
+
+    int delta = (int)changed.size() - (to - from);
+    dir.erase(dir.begin() + from, dir.begin() + to);
+    dir.insert(dir.begin() + from, changed.begin(), changed.end());
+
+    // 바뀐 범위를 덮는 segment들 [si, sj]
+    int si = 0;
+    while (si + 1 < (int)segments.size() && segments[si].end <= from) si++;
+    int sj = si;
+    while (sj + 1 < (int)segments.size() && segments[sj].end < to) sj++;
+    for (int s = sj + 1; s < (int)segments.size(); s++) {
+        segments[s].start += delta;
+        segments[s].end += delta;
+    }
+
+    Segment& seg = segments[si];
+    seg.end += delta;
+    seg.extra += (to - from) + changed.size();
+    if (si == sj && seg.end > seg.start && seg.extra <= error && seg.end - seg.start <= 2 * MAX_SEGMENT) {
+        seg.first = dir[seg.start].low;
+        return;
+    }
+
+    // 양옆 segment까지 함께 다시 학습해 잘게 쪼개진 segment가 다시 합쳐질 수 있게 한다.
+    int end = segments[sj].end + (si == sj ? 0 : delta);
+    if (si > 0) si--;
+    if (sj + 1 < (int)segments.size()) end = segments[++sj].end;
+    vector<Segment> fitted;
+    fit(segments[si].start, end, fitted);
+    segments.erase(segments.begin() + si, segments.begin() + sj + 1);
+    segments.insert(segments.begin() + si, fitted.begin(), fitted.end());
+    retrains++;
+}
+
+// ---------------- Operations ----------------
+
+template <typename T>
+bool LearnedBPlusTree<T>::search(T k) {
+    this->vis->clear();
+    this->vis->setTitle("Learned search: " + DataNode<T>::toString(k));
+    if (this->bloom && !this->bloom->mayContain(k)) {
+        this->vis->setMessage("Bloom filter: key is definitely absent.");
+        this->vis->render();
+        return false;
+    }
+
+    int idx = locate(k);
+    if (idx < 0) {
+        this->vis->setMessage("Tree is Empty.");
+        this->vis->render();
+        return false;
+    }
+    this->stats.visited++;
+    BPlusTreeNode<T>* leaf = dir[idx].leaf;
+    int i = lower_bound(&leaf->key[0], &leaf->key[0] + leaf->key_count, k) - &leaf->key[0];
+    bool found = i < leaf->key_count && leaf->key[i] == k && !leaf->tombstone[i];
+    if (this->bloom && !found) this->bloom->noteFalsePositive();
+
+    this->vis->setMessage("Model predicted leaf " + DataNode<int>::toString(idx) + (found ? ". Found!" : ". Not found."));
+    this->vis->setColor(leaf, Color::RESET);
+    if (found) this->vis->setColor(leaf, i, Color::GREEN);
+    else this->vis->setColor(leaf, Color::RED);
+    this->vis->render();
+    return found;
+}
+
+// 키가 들어가는 리프는 locate(k) 또는 그 다음 리프이고, split은 그 리프 오른쪽에 새 리프를 만든다.
+// 이미 있는 키여도 내려가며 꽉 찬 노드를 나누므로 항상 고친다.
+template <typename T>
+bool LearnedBPlusTree<T>::insert(T k) {
+    int j = locate(k);
+    bool inserted = BPlusTree<T>::insert(k);
+    if (j < 0) train();
+    else refresh(j, min(j + 2, (int)dir.size()));
+    return inserted;
+}
+
+// 리프 단계의 borrow/merge는 대상 리프(j 또는 j+1)와 그 이웃만 건드리고, merge는 오른쪽 리프를 지운다.
+// 그래서 dir[j-1]과 dir[j+3]은 남아 있다. 없는 키를 지워도 내려가며 borrow/merge를 하므로 항상 고친다.
+template <typename T>
+bool LearnedBPlusTree<T>::remove(T k) {
+    int j = locate(k);
+    bool lazy = this->lazy_delete;
+    bool removed = BPlusTree<T>::remove(k);
+    if (j < 0 || (lazy && !removed)) return removed;
+    if (this->root_ptr == nullptr || lazy) {
+        if (this->root_ptr == nullptr || this->tombstone_count == 0) train();  // 비었거나 compact됨
+    } else {
+        refresh(max(j - 1, 0), min(j + 3, (int)dir.size()));
+    }
+    return removed;
+}
+
+// 큰 쪽은 예측한 리프에서 시작해 리프 체인을 따라간다. 작은 쪽은 B+ 트리 하강을 그대로 쓴다.
+template <typename T>
+optional<T> LearnedBPlusTree<T>::bound(T x, bool greater, bool inclusive) {
+    if (!greater) return BPlusTree<T>::bound(x, greater, inclusive);
+    this->vis->clear();
+    this->vis->setTitle(this->boundTitle(greater, inclusive) + " of: " + DataNode<T>::toString(x));
+
+    int idx = locate(x);
+    for (BPlusTreeNode<T>* leaf = idx < 0 ? nullptr : dir[idx].leaf; leaf; leaf = leaf->next) {
+        this->stats.visited++;
+        for (int i = 0; i < leaf->key_count; i++) {
+            if (leaf->tombstone[i]) continue;
+            if (inclusive ? !(leaf->key[i] < x) : x < leaf->key[i]) {
+                this->vis->setMessage("Result: " + DataNode<T>::toString(leaf->key[i]));
+                this->vis->setColor(leaf, i, Color::GREEN);
+                this->vis->render();
+                return leaf->key[i];
+            }
+        }
+    }
+    this->vis->setMessage("No such key.");
+    this->vis->render();
+    return nullopt;
+}
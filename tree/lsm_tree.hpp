@@ -0,0 +1,361 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <queue>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include "rbtree.hpp"
+#include "bplustree.hpp"
+
+using namespace std;
+
+// 쓰기를 모았다가 정렬된 덩어리로 내리는 LSM(log-structured merge) 인덱스.
+//   memtable : 쓰기를 받는 RBTree. 지운 키는 tombstone용 RBTree에 따로 둔다.
+//   run      : memtable이 memtable_limit개가 되면 얼려서 bulkLoad로 한 번에 만든 불변 BPlusTree.
+//              그 시점의 tombstone은 정렬된 배열로 함께 두어 더 오래된 run의 같은 키를 가린다.
+// run은 레벨(tier)별로 모이고, 같은 레벨의 run이 fan_in개가 되면 백그라운드 스레드가 하나로 병합해 다음 레벨로 올린다.
+// 가장 오래된 run까지 병합하면 가릴 것이 없으므로 tombstone을 버린다.
+// search는 memtable, run을 최신부터 오래된 순으로 보고 처음 만난 판정을 따른다 (run마다 Bloom 필터를 먼저 본다).
+// rangeScan은 모든 출처를 k-way 병합하며 같은 키는 가장 최근 판정만 남긴다.
+// insert/remove는 memtable에만 쓰므로 키가 이미 있었는지 모르고 항상 true를 반환한다.
+// 병합 스레드 말고는 한 스레드에서 써야 한다. 안쪽 트리들도 시각화 대상이므로 보통 출력을 끄고 쓴다.
+template <typename T>
+class LSMTree {
+public:
+    // background가 false면 병합을 flush하는 스레드에서 바로 한다.
+    explicit LSMTree(int memtable_limit = 4096, int fan_in = 4, int t = 16, bool background = true, double bloom_fpr = 0.01)
+        : memtable_limit(max(memtable_limit, 1)), fan_in(max(fan_in, 2)), t(t), background(background),
+          bloom_fpr(bloom_fpr), live(new RBTree<T>()), deleted(new RBTree<T>()) {}
+    ~LSMTree() { waitForCompaction(); }
+    LSMTree(const LSMTree&) = delete;
+    LSMTree& operator=(const LSMTree&) = delete;
+
+    bool search(T k);
+    bool insert(T k);
+    bool remove(T k);
+
+    // [begin, end] 안의 살아 있는 키를 순서대로 f에 넘긴다. 하나라도 있었는지 반환.
+    // 도는 동안 병합 결과를 끼워 넣지 못하게 run 목록을 잡고 있다.
+    template <typename F>
+    bool rangeScan(T begin, T end, F f);
+    bool rangeSearch(T begin, T end) {
+        return rangeScan(begin, end, [](const T&) {});
+    }
+
+    // memtable을 지금 run으로 내린다.
+    void flush();
+    // 진행 중인 병합이 (이어서 생긴 병합까지) 모두 끝날 때까지 기다린다.
+    void waitForCompaction();
+
+    size_t getMemtableSize() const { return memtable_size; }
+    int getRunCount() {
+        lock_guard<mutex> lock(runs_mutex);
+        return runs.size();
+    }
+    long long getCompactionCount() {
+        lock_guard<mutex> lock(runs_mutex);
+        return compactions;
+    }
+
+private:
+    struct Run {
+        BPlusTree<T> keys;
+        vector<T> tombstones;
+        int level;
+        Run(int t, int level) : keys(t), level(level) {}
+    };
+
+    // 한 출처(memtable 또는 run)의 정렬된 (키, 살아 있음) 흐름. 살아 있는 키와 tombstone은 겹치지 않는다.
+    // 살아 있는 키는 run이면 리프 체인에서, memtable이면 배열에서 읽는다.
+    struct Cursor {
+        BPlusTreeNode<T>* leaf = nullptr;
+        int i = 0;
+        const T* live = nullptr;
+        const T* live_end = nullptr;
+        const T* dead = nullptr;
+        const T* dead_end = nullptr;
+
+        bool hasLive() const { return leaf != nullptr || live != live_end; }
+        const T& liveKey() const { return leaf != nullptr ? leaf->key[i] : *live; }
+        bool valid() const { return hasLive() || dead != dead_end; }
+        bool isLive() const { return hasLive() && (dead == dead_end || liveKey() < *dead); }
+        const T& key() const { return isLive() ? liveKey() : *dead; }
+        void advance() {
+            if (!isLive()) {
+                ++dead;
+            } else if (leaf == nullptr) {
+                ++live;
+            } else {
+                ++i;
+                skipEmpty();
+            }
+        }
+        void skipEmpty() {
+            while (leaf != nullptr && i >= leaf->key_count) {
+                leaf = leaf->next;
+                i = 0;
+            }
+        }
+    };
+
+    int memtable_limit;
+    int fan_in;
+    int t;
+    bool background;
+    double bloom_fpr;
+
+    unique_ptr<RBTree<T>> live;
+    unique_ptr<RBTree<T>> deleted;
+    size_t memtable_size = 0;
+
+    // 오래된 것부터. 레벨은 앞쪽일수록 크거나 같다 (같은 레벨의 run은 항상 붙어 있다).
+    vector<shared_ptr<Run>> runs;
+    mutex runs_mutex;
+    condition_variable idle;
+    bool compacting = false;
+    long long compactions = 0;
+    thread worker;
+
+    static bool memHas(RBTree<T>& tree, const T& k);
+    static optional<bool> runHas(Run& run, const T& k);
+    static Cursor runCursor(Run& run, const T* begin);
+    static void mergeCursors(vector<Cursor>& cursors, const T* end, const function<void(const T&, bool)>& emit);
+
+    bool pickTier(size_t& lo, size_t& hi);
+    void scheduleCompaction();
+    void compactLoop();
+    shared_ptr<Run> mergeRuns(const vector<shared_ptr<Run>>& inputs, int level, bool bottom);
+};
+
+// RBTree::search는 단계마다 시각화 메시지를 만들므로 조용한 범위 순회로 확인한다.
+template <typename T>
+bool LSMTree<T>::memHas(RBTree<T>& tree, const T& k) {
+    bool found = false;
+    tree.forEachInRange(k, k, [&](const T&) { found = true; });
+    return found;
+}
+
+// 이 run이 판정을 내리면 그 값, 모르면 nullopt (더 오래된 run을 봐야 한다).
+template <typename T>
+optional<bool> LSMTree<T>::runHas(Run& run, const T& k) {
+    if (binary_search(run.tombstones.begin(), run.tombstones.end(), k)) return false;
+    BPlusTree<T>& tree = run.keys;
+    if (tree.root_ptr == nullptr) return nullopt;
+    if (tree.bloom && !tree.bloom->mayContain(k)) return nullopt;
+    BPlusTreeNode<T>* leaf = tree.findLeaf(k);
+    auto first = leaf->key.begin(), last = first + leaf->key_count;
+    if (binary_search(first, last, k)) return true;
+    if (tree.bloom) tree.bloom->noteFalsePositive();
+    return nullopt;
+}
+
+// begin이 nullptr이면 처음부터.
+template <typename T>
+typename LSMTree<T>::Cursor LSMTree<T>::runCursor(Run& run, const T* begin) {
+    Cursor c;
+    BPlusTree<T>& tree = run.keys;
+    if (tree.root_ptr != nullptr) {
+        BPlusTreeNode<T>* root = dynamic_cast<BPlusTreeNode<T>*>(tree.root_ptr);
+        c.leaf = begin ? tree.findLeaf(*begin) : BPlusTree<T>::edgeLeaf(root, false);
+        if (begin) c.i = lower_bound(c.leaf->key.begin(), c.leaf->key.begin() + c.leaf->key_count, *begin) - c.leaf->key.begin();
+        c.skipEmpty();
+    }
+    c.dead = run.tombstones.data();
+    c.dead_end = c.dead + run.tombstones.size();
+    if (begin) c.dead = lower_bound(c.dead, c.dead_end, *begin);
+    return c;
+}
+
+// cursors[0]이 가장 최근이다. 키마다 가장 최근 출처의 판정 하나만 emit한다. end가 있으면 그 키를 넘으면 멈춘다.
+template <typename T>
+void LSMTree<T>::mergeCursors(vector<Cursor>& cursors, const T* end, const function<void(const T&, bool)>& emit) {
+    auto later = [&](int a, int b) {
+        const T& ka = cursors[a].key();
+        const T& kb = cursors[b].key();
+        if (ka < kb) return false;
+        if (kb < ka) return true;
+        return a > b;
+    };
+    priority_queue<int, vector<int>, decltype(later)> heap(later);
+    for (int i = 0; i < (int)cursors.size(); i++)
+        if (cursors[i].valid()) heap.push(i);
+
+    while (!heap.empty()) {
+        int i = heap.top();
+        heap.pop();
+        T k = cursors[i].key();
+        if (end && *end < k) break;
+        emit(k, cursors[i].isLive());
+
+        // 같은 키의 더 오래된 항목은 버린다.
+        cursors[i].advance();
+        if (cursors[i].valid()) heap.push(i);
+        while (!heap.empty() && !(k < cursors[heap.top()].key())) {
+            int j = heap.top();
+            heap.pop();
+            cursors[j].advance();
+            if (cursors[j].valid()) heap.push(j);
+        }
+    }
+}
+
+template <typename T>
+bool LSMTree<T>::search(T k) {
+    if (memHas(*live, k)) return true;
+    if (memHas(*deleted, k)) return false;
+
+    lock_guard<mutex> lock(runs_mutex);
+    for (size_t i = runs.size(); i-- > 0;) {
+        optional<bool> verdict = runHas(*runs[i], k);
+        if (verdict) return *verdict;
+    }
+    return false;
+}
+
+template <typename T>
+bool LSMTree<T>::insert(T k) {
+    if (memHas(*deleted, k)) {
+        deleted->remove(k);
+        memtable_size--;
+    }
+    if (live->insert(k)) memtable_size++;
+    if ((int)memtable_size >= memtable_limit) flush();
+    return true;
+}
+
+template <typename T>
+bool LSMTree<T>::remove(T k) {
+    if (memHas(*live, k)) {
+        live->remove(k);
+        memtable_size--;
+    }
+    if (deleted->insert(k)) memtable_size++;
+    if ((int)memtable_size >= memtable_limit) flush();
+    return true;
+}
+
+template <typename T>
+template <typename F>
+bool LSMTree<T>::rangeScan(T begin, T end, F f) {
+    vector<T> mem_live, mem_dead;
+    live->forEachInRange(begin, end, [&](const T& k) { mem_live.push_back(k); });
+    deleted->forEachInRange(begin, end, [&](const T& k) { mem_dead.push_back(k); });
+
+    lock_guard<mutex> lock(runs_mutex);
+    vector<Cursor> cursors(1);
+    cursors[0].live = mem_live.data();
+    cursors[0].live_end = mem_live.data() + mem_live.size();
+    cursors[0].dead = mem_dead.data();
+    cursors[0].dead_end = mem_dead.data() + mem_dead.size();
+    for (size_t i = runs.size(); i-- > 0;) cursors.push_back(runCursor(*runs[i], &begin));
+
+    bool found_any = false;
+    mergeCursors(cursors, &end, [&](const T& k, bool alive) {
+        if (!alive) return;
+        f(k);
+        found_any = true;
+    });
+    return found_any;
+}
+
+// memtable을 얼려 키 순서대로 꺼내고 bulkLoad로 run을 만든다. 변환은 O(n)이라 쓰는 스레드에서 바로 한다.
+template <typename T>
+void LSMTree<T>::flush() {
+    if (memtable_size == 0) return;
+    auto run = make_shared<Run>(t, 0);
+    vector<T> keys;
+    keys.reserve(memtable_size);
+    live->forEach([&](const T& k) { keys.push_back(k); });
+    deleted->forEach([&](const T& k) { run->tombstones.push_back(k); });
+    run->keys.bulkLoad(keys);
+    run->keys.setBloomFilter(true, bloom_fpr);
+    live.reset(new RBTree<T>());
+    deleted.reset(new RBTree<T>());
+    memtable_size = 0;
+
+    {
+        lock_guard<mutex> lock(runs_mutex);
+        if (runs.empty()) run->tombstones.clear();  // 가릴 오래된 run이 없다
+        runs.push_back(run);
+    }
+    scheduleCompaction();
+}
+
+// 가장 최근 쪽부터 같은 레벨의 run 묶음을 보고, fan_in개 이상인 첫 묶음 [lo, hi)를 고른다.
+template <typename T>
+bool LSMTree<T>::pickTier(size_t& lo, size_t& hi) {
+    hi = runs.size();
+    while (hi > 0) {
+        lo = hi;
+        while (lo > 0 && runs[lo - 1]->level == runs[hi - 1]->level) lo--;
+        if (hi - lo >= (size_t)fan_in) return true;
+        hi = lo;
+    }
+    return false;
+}
+
+template <typename T>
+void LSMTree<T>::scheduleCompaction() {
+    size_t lo, hi;
+    {
+        lock_guard<mutex> lock(runs_mutex);
+        if (compacting || !pickTier(lo, hi)) return;
+        compacting = true;
+    }
+    if (!background) {
+        compactLoop();
+        return;
+    }
+    if (worker.joinable()) worker.join();  // 이미 끝난 이전 병합 스레드
+    worker = thread([this] { compactLoop(); });
+}
+
+// 병합하는 동안에는 run 목록을 놓아 주므로 search/flush가 계속 진행된다.
+// 병합 대상은 연속된 구간이고 run을 빼는 것은 이 스레드뿐이라, 그동안 뒤에 run이 붙어도 [lo, hi)는 그대로다.
+template <typename T>
+void LSMTree<T>::compactLoop() {
+    unique_lock<mutex> lock(runs_mutex);
+    size_t lo, hi;
+    while (pickTier(lo, hi)) {
+        vector<shared_ptr<Run>> inputs(runs.begin() + lo, runs.begin() + hi);
+        int level = inputs[0]->level + 1;
+        bool bottom = lo == 0;
+        lock.unlock();
+        shared_ptr<Run> merged = mergeRuns(inputs, level, bottom);
+        lock.lock();
+        runs.erase(runs.begin() + lo, runs.begin() + hi);
+        runs.insert(runs.begin() + lo, merged);
+        compactions++;
+    }
+    compacting = false;
+    idle.notify_all();
+}
+
+template <typename T>
+shared_ptr<typename LSMTree<T>::Run> LSMTree<T>::mergeRuns(const vector<shared_ptr<Run>>& inputs, int level, bool bottom) {
+    vector<Cursor> cursors;
+    for (size_t i = inputs.size(); i-- > 0;) cursors.push_back(runCursor(*inputs[i], nullptr));
+
+    auto out = make_shared<Run>(t, level);
+    vector<T> keys;
+    mergeCursors(cursors, nullptr, [&](const T& k, bool alive) {
+        if (alive) keys.push_back(k);
+        else if (!bottom) out->tombstones.push_back(k);
+    });
+    out->keys.bulkLoad(keys);
+    out->keys.setBloomFilter(true, bloom_fpr);
+    return out;
+}
+
+template <typename T>
+void LSMTree<T>::waitForCompaction() {
+    {
+        unique_lock<mutex> lock(runs_mutex);
+        idle.wait(lock, [&] { return !compacting; });
+    }
+    if (worker.joinable()) worker.join();
+}
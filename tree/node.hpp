@@ -2,6 +2,8 @@
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <string>
+#include <type_traits>
 using namespace std;
 
 class Visualizer;
@@ -16,6 +18,11 @@ public:
 
     template <typename T>
     static string toString(T data) {
+        // 정수는 stringstream보다 훨씬 싼 to_string으로 (char 계열은 문자로 출력되므로 제외)
+        if constexpr (is_integral_v<T> && !is_same_v<T, bool> && !is_same_v<T, char>
+                      && !is_same_v<T, signed char> && !is_same_v<T, unsigned char>) {
+            return to_string(data);
+        }
         stringstream ss;
         ss << data;
         return ss.str();
@@ -30,9 +37,7 @@ public:
     int getKeyCount() const { return key_count; }
 
     static string toString(T data) {
-        stringstream ss;
-        ss << data;
-        return ss.str();
+        return Node::toString(data);
     }
 
 protected:
@@ -42,4 +47,5 @@ protected:
     int children_count = 0;
 
     friend class Visualizer;
+    template <typename> friend class DataTree;
 };
\ No newline at end of file
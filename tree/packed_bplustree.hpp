@@ -0,0 +1,284 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+
+using namespace std;
+
+// 정수 키 전용 B+ 트리. 리프는 frame-of-reference + bit-packing으로 저장한다.
+//   리프 = base(최솟값) + 각 키의 (key - base)를 bits 비트씩 빈틈없이 채운 uint64 배열
+// 촘촘한 ID라면 delta 범위가 작아서 키당 8바이트 대신 1~2바이트만 쓴다.
+// 모든 칸의 폭이 같으므로 i번째 키는 풀지 않고 바로 꺼낼 수 있다(at).
+// 그래서 search는 리프 안에서 분기 없는 이분 탐색을 하고, rangeScan은 비트 위치를 옮겨 가며 하나씩 흘려보낸다.
+// insert/remove는 리프를 풀어서 고친 뒤 다시 인코딩한다 (리프 크기에 비례).
+// remove는 리프를 합치지 않으므로 빈 리프가 남을 수 있다. 시각화는 지원하지 않는다.
+template <typename T>
+class PackedBPlusTree {
+    static_assert(is_integral<T>::value, "PackedBPlusTree needs an integral key type");
+    using U = typename make_unsigned<T>::type;
+
+public:
+    explicit PackedBPlusTree(int leaf_capacity = 256, int fanout = 64)
+        : leaf_capacity(max(leaf_capacity, 2)), fanout(max(fanout, 3)) {}
+    ~PackedBPlusTree() { freeSubtree(root); }
+    PackedBPlusTree(const PackedBPlusTree&) = delete;
+    PackedBPlusTree& operator=(const PackedBPlusTree&) = delete;
+
+    bool search(T k) const {
+        const Leaf* leaf = findLeaf(k);
+        if (leaf == nullptr) return false;
+        int i = leaf->lowerIndex(k);
+        return i < leaf->count && leaf->key(i) == k;
+    }
+
+    optional<T> lowerBound(T k) const {
+        for (const Leaf* leaf = findLeaf(k); leaf != nullptr; leaf = leaf->next) {
+            int i = leaf->lowerIndex(k);
+            if (i < leaf->count) return leaf->key(i);
+        }
+        return nullopt;
+    }
+
+    // [begin, end] 안의 키를 순서대로 f에 넘긴다. 하나라도 있었는지 반환.
+    template <typename F>
+    bool rangeScan(T begin, T end, F f) const {
+        bool found_any = false;
+        for (const Leaf* leaf = findLeaf(begin); leaf != nullptr; leaf = leaf->next) {
+            for (Cursor c(leaf, leaf->lowerIndex(begin)); c.i < leaf->count; c.advance()) {
+                T k = c.key();
+                if (end < k) return found_any;
+                f(k);
+                found_any = true;
+            }
+        }
+        return found_any;
+    }
+    bool rangeSearch(T begin, T end) const {
+        return rangeScan(begin, end, [](T) {});
+    }
+
+    bool insert(T k);
+    bool remove(T k);
+
+    size_t size() const { return key_count; }
+    size_t leafCount() const { return leaf_count; }
+    // 리프의 키 저장에 쓰는 바이트 (base, 패킹된 word)
+    size_t leafBytes() const;
+
+private:
+    struct Node {
+        bool leaf;
+        explicit Node(bool leaf) : leaf(leaf) {}
+    };
+
+    struct Inner : Node {
+        vector<T> keys;          // left < keys[i] <= right
+        vector<Node*> children;  // keys.size() + 1개
+        Inner() : Node(false) {}
+    };
+
+    struct Leaf : Node {
+        T base = 0;
+        int bits = 0;
+        int count = 0;
+        vector<uint64_t> words;  // 두 word에 걸친 칸을 분기 없이 읽도록 끝에 한 word를 더 둔다
+        Leaf* next = nullptr;
+        Leaf() : Node(true) {}
+
+        uint64_t mask() const { return bits == 64 ? ~0ull : (1ull << bits) - 1; }
+
+        // i번째 칸의 delta. 다음 word를 항상 읽고, sh == 0이면 (x << 1) << 63 으로 0이 된다.
+        uint64_t at(int i) const {
+            uint64_t pos = (uint64_t)i * bits;
+            size_t w = pos >> 6;
+            unsigned sh = pos & 63;
+            uint64_t v = (words[w] >> sh) | ((words[w + 1] << 1) << (63 - sh));
+            return v & mask();
+        }
+
+        T key(int i) const { return T(U(base) + U(at(i))); }
+
+        // 첫 번째 k 이상 키의 위치. 비교는 base 기준 delta(부호 없는 값)로 한다.
+        int lowerIndex(T k) const {
+            if (count == 0 || !(base < k)) return 0;
+            uint64_t d = uint64_t(U(k) - U(base));
+            int lo = 0, len = count;
+            while (len > 1) {
+                int half = len / 2;
+                lo = at(lo + half) < d ? lo + half : lo;
+                len -= half;
+            }
+            return lo + (at(lo) < d);
+        }
+
+        void encode(const vector<T>& keys) {
+            count = keys.size();
+            base = count ? keys[0] : 0;
+            uint64_t range = count ? uint64_t(U(keys.back()) - U(base)) : 0;
+            bits = 0;
+            while (bits < 64 && (range >> bits) != 0) bits++;
+
+            words.assign((uint64_t)count * bits / 64 + 2, 0);
+            for (int i = 0; i < count && bits > 0; i++) {
+                uint64_t v = uint64_t(U(keys[i]) - U(base));
+                uint64_t pos = (uint64_t)i * bits;
+                size_t w = pos >> 6;
+                unsigned sh = pos & 63;
+                words[w] |= v << sh;
+                if (sh + bits > 64) words[w + 1] |= v >> (64 - sh);
+            }
+            words.shrink_to_fit();
+        }
+
+        void decode(vector<T>& out) const {
+            out.clear();
+            for (Cursor c(this, 0); c.i < count; c.advance()) out.push_back(c.key());
+        }
+    };
+
+    // 리프를 앞에서부터 읽는 커서. 칸 번호 대신 비트 위치를 들고 다닌다.
+    struct Cursor {
+        const Leaf* leaf;
+        int i;
+        uint64_t pos;
+        Cursor(const Leaf* leaf, int i) : leaf(leaf), i(i), pos((uint64_t)i * leaf->bits) {}
+        void advance() {
+            i++;
+            pos += leaf->bits;
+        }
+        T key() const {
+            size_t w = pos >> 6;
+            unsigned sh = pos & 63;
+            uint64_t v = (leaf->words[w] >> sh) | ((leaf->words[w + 1] << 1) << (63 - sh));
+            return T(U(leaf->base) + U(v & leaf->mask()));
+        }
+    };
+
+    int leaf_capacity;
+    int fanout;
+    Node* root = nullptr;
+    size_t key_count = 0;
+    size_t leaf_count = 0;
+
+    static int route(const Inner* x, T k) {
+        return upper_bound(x->keys.begin(), x->keys.end(), k) - x->keys.begin();
+    }
+
+    const Leaf* findLeaf(T k) const {
+        const Node* x = root;
+        while (x && !x->leaf) {
+            const Inner* in = static_cast<const Inner*>(x);
+            x = in->children[route(in, k)];
+        }
+        return static_cast<const Leaf*>(x);
+    }
+
+    static void freeSubtree(Node* x) {
+        if (x == nullptr) return;
+        if (x->leaf) {
+            delete static_cast<Leaf*>(x);
+            return;
+        }
+        Inner* in = static_cast<Inner*>(x);
+        for (Node* c : in->children) freeSubtree(c);
+        delete in;
+    }
+};
+
+// 내려간 경로를 기억했다가, 리프가 넘치면 반으로 나누고 구분 키를 위로 올린다.
+// 내부 노드도 자식이 fanout을 넘으면 가운데 키를 올리며 나눈다.
+template <typename T>
+bool PackedBPlusTree<T>::insert(T k) {
+    if (root == nullptr) {
+        Leaf* leaf = new Leaf();
+        leaf->encode({k});
+        root = leaf;
+        key_count = leaf_count = 1;
+        return true;
+    }
+
+    vector<pair<Inner*, int>> path;
+    Node* x = root;
+    while (!x->leaf) {
+        Inner* in = static_cast<Inner*>(x);
+        int i = route(in, k);
+        path.push_back({in, i});
+        x = in->children[i];
+    }
+    Leaf* leaf = static_cast<Leaf*>(x);
+    int idx = leaf->lowerIndex(k);
+    if (idx < leaf->count && leaf->key(idx) == k) return false;
+
+    vector<T> keys;
+    leaf->decode(keys);
+    keys.insert(keys.begin() + idx, k);
+    key_count++;
+    if ((int)keys.size() <= leaf_capacity) {
+        leaf->encode(keys);
+        return true;
+    }
+
+    // 오른쪽 끝 리프에 최댓값이 들어오면 (순차 ID) 왼쪽을 가득 채운 채 마지막 키만 떼어 낸다.
+    bool append = leaf->next == nullptr && idx == (int)keys.size() - 1;
+    int keep = append ? keys.size() - 1 : keys.size() / 2;
+    Leaf* right = new Leaf();
+    right->encode(vector<T>(keys.begin() + keep, keys.end()));
+    keys.resize(keep);
+    leaf->encode(keys);
+    right->next = leaf->next;
+    leaf->next = right;
+    leaf_count++;
+
+    T sep = right->key(0);
+    Node* new_child = right;
+    while (!path.empty()) {
+        Inner* p = path.back().first;
+        int i = path.back().second;
+        path.pop_back();
+        p->keys.insert(p->keys.begin() + i, sep);
+        p->children.insert(p->children.begin() + i + 1, new_child);
+        if ((int)p->children.size() <= fanout) return true;
+
+        int mid = p->keys.size() / 2;
+        Inner* q = new Inner();
+        sep = p->keys[mid];
+        q->keys.assign(p->keys.begin() + mid + 1, p->keys.end());
+        q->children.assign(p->children.begin() + mid + 1, p->children.end());
+        p->keys.resize(mid);
+        p->children.resize(mid + 1);
+        new_child = q;
+    }
+
+    Inner* r = new Inner();
+    r->keys.push_back(sep);
+    r->children = {root, new_child};
+    root = r;
+    return true;
+}
+
+template <typename T>
+bool PackedBPlusTree<T>::remove(T k) {
+    Leaf* leaf = const_cast<Leaf*>(findLeaf(k));
+    if (leaf == nullptr) return false;
+    int idx = leaf->lowerIndex(k);
+    if (idx >= leaf->count || leaf->key(idx) != k) return false;
+
+    vector<T> keys;
+    leaf->decode(keys);
+    keys.erase(keys.begin() + idx);
+    leaf->encode(keys);
+    key_count--;
+    return true;
+}
+
+template <typename T>
+size_t PackedBPlusTree<T>::leafBytes() const {
+    const Node* x = root;
+    while (x && !x->leaf) x = static_cast<const Inner*>(x)->children[0];
+    size_t bytes = 0;
+    for (const Leaf* leaf = static_cast<const Leaf*>(x); leaf; leaf = leaf->next)
+        bytes += sizeof(T) + leaf->words.size() * sizeof(uint64_t);
+    return bytes;
+}
@@ -0,0 +1,459 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include "buffer_pool.hpp"
+
+using namespace std;
+
+// 노드가 파일의 고정 크기 페이지에 있는 B+ 트리. 메모리보다 큰 데이터를 위한 것이다.
+// 자식과 next는 포인터 대신 PageId이고, 노드는 BufferPool로 pin한 frame 위에서 직접 고친다.
+// 삽입(선제 split, 오른쪽 끝 append split)과 삭제(fill/borrow/merge)는 BPlusTree와 같은 방식이다.
+// 노드가 메모리에 상주하지 않으므로 시각화와 lazy delete는 지원하지 않는다.
+// 한 번에 pin하는 페이지는 부모, 자식, 형제, 새 페이지까지 최대 4개다.
+template <typename T>
+class PagedBPlusTree {
+    static_assert(is_trivially_copyable<T>::value, "paged keys must be trivially copyable");
+
+public:
+    // path 파일이 없거나 truncate면 새 트리를 만들고, 아니면 저장된 트리를 연다.
+    PagedBPlusTree(const string& path, uint32_t page_size = 4096, size_t pool_frames = 256, bool truncate = false)
+        : pool(path, page_size, pool_frames, truncate), t(degreeFor(page_size)) {
+        if (t < 2) throw runtime_error("PagedBPlusTree: page size too small for key type");
+        if (pool.isNewFile()) {
+            saveMeta();
+        } else {
+            Meta m;
+            memcpy(&m, pool.meta(), sizeof(m));
+            if (memcmp(m.magic, "TVIZBPT1", 8) != 0 || m.key_size != sizeof(T) || m.t != (uint32_t)t)
+                throw runtime_error("PagedBPlusTree: " + path + " holds a different tree layout");
+            root = m.root;
+            count = m.count;
+        }
+    }
+
+    ~PagedBPlusTree() { saveMeta(); }
+
+    bool search(T k);
+    bool insert(T k);
+    bool remove(T k);
+    // [begin, end] 안의 키를 순서대로 f에 넘긴다. 하나라도 있었는지 반환.
+    template <typename F>
+    bool rangeScan(T begin, T end, F f);
+    bool rangeSearch(T begin, T end) {
+        return rangeScan(begin, end, [](T) {});
+    }
+    optional<T> lowerBound(T k);
+
+    // 메타(루트, 키 수)와 dirty 페이지를 파일에 쓴다.
+    void flush() {
+        saveMeta();
+        pool.flush();
+    }
+
+    uint64_t size() const { return count; }
+    int degree() const { return t; }
+    BufferPool::Stats getPoolStats() const { return pool.getStats(); }
+    void resetPoolStats() { pool.resetStats(); }
+
+private:
+    struct Meta {
+        char magic[8];
+        uint32_t key_size;
+        uint32_t t;
+        PageId root;
+        uint32_t pad;
+        uint64_t count;
+    };
+
+    // 페이지 배치: uint32 leaf | uint32 key_count | PageId next | uint32 (pad) | T key[2t-1] | PageId child[2t]
+    static const uint32_t HEADER = 16;
+
+    // pin된 frame을 노드처럼 읽고 쓰는 뷰. 값은 memcpy로 옮겨 정렬에 기대지 않는다.
+    struct Node {
+        char* p;
+        int t;
+
+        bool leaf() const { return get<uint32_t>(0) != 0; }
+        void setLeaf(bool leaf) { set<uint32_t>(0, leaf); }
+        int count() const { return get<uint32_t>(4); }
+        void setCount(int n) { set<uint32_t>(4, n); }
+        PageId next() const { return get<PageId>(8); }
+        void setNext(PageId id) { set<PageId>(8, id); }
+
+        T key(int i) const { return get<T>(HEADER + sizeof(T) * i); }
+        void setKey(int i, T k) { set<T>(HEADER + sizeof(T) * i, k); }
+        PageId child(int i) const { return get<PageId>(childrenAt() + sizeof(PageId) * i); }
+        void setChild(int i, PageId id) { set<PageId>(childrenAt() + sizeof(PageId) * i, id); }
+
+        // [from, count)를 to로 옮긴다 (겹쳐도 된다).
+        void shiftKeys(int from, int to, int n) {
+            if (n > 0) memmove(p + HEADER + sizeof(T) * to, p + HEADER + sizeof(T) * from, sizeof(T) * n);
+        }
+        void shiftChildren(int from, int to, int n) {
+            char* base = p + childrenAt();
+            if (n > 0) memmove(base + sizeof(PageId) * to, base + sizeof(PageId) * from, sizeof(PageId) * n);
+        }
+
+        // 첫 번째 k 이상 키의 위치
+        int lowerIndex(T k) const {
+            int lo = 0, hi = count();
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (key(mid) < k) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        }
+        // 내부 노드에서 k가 내려갈 자식 (k >= key[i]면 오른쪽)
+        int route(T k) const {
+            int lo = 0, hi = count();
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (!(k < key(mid))) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo;
+        }
+
+        size_t childrenAt() const { return HEADER + sizeof(T) * (2 * t - 1); }
+        template <typename U>
+        U get(size_t at) const {
+            U v;
+            memcpy(&v, p + at, sizeof(U));
+            return v;
+        }
+        template <typename U>
+        void set(size_t at, U v) { memcpy(p + at, &v, sizeof(U)); }
+    };
+
+    BufferPool pool;
+    int t;
+    PageId root = INVALID_PAGE;
+    uint64_t count = 0;
+
+    static int degreeFor(uint32_t page_size) {
+        // HEADER + (2t-1)*sizeof(T) + 2t*sizeof(PageId) <= page_size
+        return (page_size - HEADER + sizeof(T)) / (2 * (sizeof(T) + sizeof(PageId)));
+    }
+
+    Node node(PageRef& ref) { return Node{ref.data(), t}; }
+
+    void saveMeta() {
+        Meta m{};
+        memcpy(m.magic, "TVIZBPT1", 8);
+        m.key_size = sizeof(T);
+        m.t = t;
+        m.root = root;
+        m.count = count;
+        pool.setMeta(&m, sizeof(m));
+    }
+
+    PageRef findLeaf(T k);
+    bool insertNonFull(PageRef x, T k);
+    bool isAppendSplit(Node y, T k);
+    void splitChild(PageRef& parent, int i, PageRef& y, bool append);
+    void fill(PageRef& x, int idx);
+    void borrowFromPrev(PageRef& x, int idx);
+    void borrowFromNext(PageRef& x, int idx);
+    void merge(PageRef& x, int idx);
+};
+
+// ---------------- Search ----------------
+
+template <typename T>
+PageRef PagedBPlusTree<T>::findLeaf(T k) {
+    if (root == INVALID_PAGE) return PageRef();
+    PageRef x = pool.fetch(root);
+    while (!node(x).leaf()) {
+        Node n = node(x);
+        x = pool.fetch(n.child(n.route(k)));
+    }
+    return x;
+}
+
+template <typename T>
+bool PagedBPlusTree<T>::search(T k) {
+    PageRef leaf = findLeaf(k);
+    if (!leaf) return false;
+    Node n = node(leaf);
+    int i = n.lowerIndex(k);
+    return i < n.count() && n.key(i) == k;
+}
+
+template <typename T>
+optional<T> PagedBPlusTree<T>::lowerBound(T k) {
+    PageRef leaf = findLeaf(k);
+    while (leaf) {
+        Node n = node(leaf);
+        int i = n.lowerIndex(k);
+        if (i < n.count()) return n.key(i);
+        if (n.next() == INVALID_PAGE) break;
+        leaf = pool.fetch(n.next());
+    }
+    return nullopt;
+}
+
+template <typename T>
+template <typename F>
+bool PagedBPlusTree<T>::rangeScan(T begin, T end, F f) {
+    bool found_any = false;
+    PageRef leaf = findLeaf(begin);
+    while (leaf) {
+        Node n = node(leaf);
+        for (int i = n.lowerIndex(begin); i < n.count(); i++) {
+            if (end < n.key(i)) return found_any;
+            f(n.key(i));
+            found_any = true;
+        }
+        if (n.next() == INVALID_PAGE) break;
+        leaf = pool.fetch(n.next());
+    }
+    return found_any;
+}
+
+// ---------------- Insert ----------------
+
+// BPlusTreeNode::isAppendSplit과 같다: 오른쪽 끝 리프에 최댓값보다 큰 키가 오면 마지막 키 하나만 떼어 낸다.
+template <typename T>
+bool PagedBPlusTree<T>::isAppendSplit(Node y, T k) {
+    return y.leaf() && y.next() == INVALID_PAGE && y.key(y.count() - 1) < k;
+}
+
+template <typename T>
+void PagedBPlusTree<T>::splitChild(PageRef& parent, int i, PageRef& y_ref, bool append) {
+    PageRef z_ref = pool.allocate();
+    Node p = node(parent), y = node(y_ref), z = node(z_ref);
+    T separator;
+
+    if (y.leaf()) {
+        int move_count = append ? 1 : t;
+        int keep_count = y.count() - move_count;
+        z.setLeaf(true);
+        memcpy(z.p + HEADER, y.p + HEADER + sizeof(T) * keep_count, sizeof(T) * move_count);
+        z.setCount(move_count);
+        y.setCount(keep_count);
+        z.setNext(y.next());
+        y.setNext(z_ref.id());
+        separator = z.key(0);
+    } else {
+        z.setLeaf(false);
+        memcpy(z.p + HEADER, y.p + HEADER + sizeof(T) * t, sizeof(T) * (t - 1));
+        memcpy(z.p + z.childrenAt(), y.p + y.childrenAt() + sizeof(PageId) * t, sizeof(PageId) * t);
+        z.setCount(t - 1);
+        y.setCount(t - 1);
+        separator = y.key(t - 1);
+    }
+
+    p.shiftChildren(i + 1, i + 2, p.count() - i);
+    p.setChild(i + 1, z_ref.id());
+    p.shiftKeys(i, i + 1, p.count() - i);
+    p.setKey(i, separator);
+    p.setCount(p.count() + 1);
+
+    parent.markDirty();
+    y_ref.markDirty();
+    z_ref.markDirty();
+}
+
+template <typename T>
+bool PagedBPlusTree<T>::insertNonFull(PageRef x, T k) {
+    while (true) {
+        Node n = node(x);
+        if (n.leaf()) {
+            int i = n.lowerIndex(k);
+            if (i < n.count() && n.key(i) == k) return false;
+            n.shiftKeys(i, i + 1, n.count() - i);
+            n.setKey(i, k);
+            n.setCount(n.count() + 1);
+            x.markDirty();
+            return true;
+        }
+
+        int i = n.route(k);
+        PageRef child = pool.fetch(n.child(i));
+        if (node(child).count() == 2 * t - 1) {
+            splitChild(x, i, child, isAppendSplit(node(child), k));
+            if (!(k < n.key(i))) child = pool.fetch(n.child(++i));
+        }
+        x = move(child);
+    }
+}
+
+template <typename T>
+bool PagedBPlusTree<T>::insert(T k) {
+    if (root == INVALID_PAGE) {
+        PageRef r = pool.allocate();
+        Node n = node(r);
+        n.setLeaf(true);
+        n.setKey(0, k);
+        n.setCount(1);
+        r.markDirty();
+        root = r.id();
+        count++;
+        return true;
+    }
+
+    PageRef r = pool.fetch(root);
+    if (node(r).count() == 2 * t - 1) {
+        PageRef s = pool.allocate();
+        node(s).setLeaf(false);
+        node(s).setChild(0, root);
+        splitChild(s, 0, r, isAppendSplit(node(r), k));
+        root = s.id();
+        r = move(s);
+    }
+    bool inserted = insertNonFull(move(r), k);
+    if (inserted) count++;
+    return inserted;
+}
+
+// ---------------- Remove ----------------
+
+template <typename T>
+bool PagedBPlusTree<T>::remove(T k) {
+    if (root == INVALID_PAGE) return false;
+
+    bool result = false;
+    PageRef x = pool.fetch(root);
+    while (true) {
+        Node n = node(x);
+        int idx = n.lowerIndex(k);
+
+        if (n.leaf()) {
+            if (idx < n.count() && n.key(idx) == k) {
+                n.shiftKeys(idx + 1, idx, n.count() - idx - 1);
+                n.setCount(n.count() - 1);
+                x.markDirty();
+                result = true;
+            }
+            break;
+        }
+
+        if (idx < n.count() && n.key(idx) == k) idx++;
+        bool last = (idx == n.count());
+        PageRef child = pool.fetch(n.child(idx));
+        if (node(child).count() < t) {
+            child.release();  // merge가 이 페이지를 free list로 보낼 수 있다
+            fill(x, idx);
+            if (last && idx > n.count()) idx--;
+            child = pool.fetch(n.child(idx));
+        }
+        x = move(child);
+    }
+    x.release();
+    if (result) count--;
+
+    PageRef r = pool.fetch(root);
+    Node rn = node(r);
+    if (rn.count() == 0) {
+        PageId old = root;
+        root = rn.leaf() ? INVALID_PAGE : rn.child(0);
+        r.release();
+        pool.release(old);
+    }
+    return result;
+}
+
+template <typename T>
+void PagedBPlusTree<T>::fill(PageRef& x, int idx) {
+    Node n = node(x);
+    if (idx != 0) {
+        PageRef prev = pool.fetch(n.child(idx - 1));
+        if (node(prev).count() >= t) {
+            prev.release();
+            borrowFromPrev(x, idx);
+            return;
+        }
+    }
+    if (idx != n.count()) {
+        PageRef next = pool.fetch(n.child(idx + 1));
+        if (node(next).count() >= t) {
+            next.release();
+            borrowFromNext(x, idx);
+            return;
+        }
+    }
+    merge(x, idx != n.count() ? idx : idx - 1);
+}
+
+template <typename T>
+void PagedBPlusTree<T>::borrowFromPrev(PageRef& x, int idx) {
+    Node p = node(x);
+    PageRef c_ref = pool.fetch(p.child(idx)), s_ref = pool.fetch(p.child(idx - 1));
+    Node c = node(c_ref), s = node(s_ref);
+
+    c.shiftKeys(0, 1, c.count());
+    if (c.leaf()) {
+        c.setKey(0, s.key(s.count() - 1));
+        p.setKey(idx - 1, c.key(0));
+    } else {
+        c.shiftChildren(0, 1, c.count() + 1);
+        c.setKey(0, p.key(idx - 1));
+        c.setChild(0, s.child(s.count()));
+        p.setKey(idx - 1, s.key(s.count() - 1));
+    }
+    c.setCount(c.count() + 1);
+    s.setCount(s.count() - 1);
+
+    x.markDirty();
+    c_ref.markDirty();
+    s_ref.markDirty();
+}
+
+template <typename T>
+void PagedBPlusTree<T>::borrowFromNext(PageRef& x, int idx) {
+    Node p = node(x);
+    PageRef c_ref = pool.fetch(p.child(idx)), s_ref = pool.fetch(p.child(idx + 1));
+    Node c = node(c_ref), s = node(s_ref);
+
+    if (c.leaf()) {
+        c.setKey(c.count(), s.key(0));
+        s.shiftKeys(1, 0, s.count() - 1);
+        p.setKey(idx, s.key(0));
+    } else {
+        c.setKey(c.count(), p.key(idx));
+        c.setChild(c.count() + 1, s.child(0));
+        p.setKey(idx, s.key(0));
+        s.shiftKeys(1, 0, s.count() - 1);
+        s.shiftChildren(1, 0, s.count());
+    }
+    c.setCount(c.count() + 1);
+    s.setCount(s.count() - 1);
+
+    x.markDirty();
+    c_ref.markDirty();
+    s_ref.markDirty();
+}
+
+template <typename T>
+void PagedBPlusTree<T>::merge(PageRef& x, int idx) {
+    Node p = node(x);
+    PageRef c_ref = pool.fetch(p.child(idx));
+    PageId sibling = p.child(idx + 1);
+    {
+        PageRef s_ref = pool.fetch(sibling);
+        Node c = node(c_ref), s = node(s_ref);
+
+        int at = c.count();
+        if (c.leaf()) {
+            c.setNext(s.next());
+        } else {
+            c.setKey(at++, p.key(idx));
+            memcpy(c.p + c.childrenAt() + sizeof(PageId) * at, s.p + s.childrenAt(), sizeof(PageId) * (s.count() + 1));
+        }
+        memcpy(c.p + HEADER + sizeof(T) * at, s.p + HEADER, sizeof(T) * s.count());
+        c.setCount(at + s.count());
+    }
+
+    p.shiftKeys(idx + 1, idx, p.count() - idx - 1);
+    p.shiftChildren(idx + 2, idx + 1, p.count() - idx - 1);
+    p.setCount(p.count() - 1);
+
+    x.markDirty();
+    c_ref.markDirty();
+    pool.release(sibling);
+}
@@ -2,9 +2,13 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include "tree.hpp"
 #include "node.hpp"
+#include "forkjoin.hpp"
+#include "snapshot.hpp"
 #include "../visualizer/visualizer.hpp"
+#include "binary_bound.hpp"
 
 using namespace std;
 
@@ -74,6 +78,18 @@ template <typename T>
 class RBTree : public DataTree<T> {
 public:
     RBTree() {}
+    ~RBTree() { freeSubtree(dynamic_cast<RBNode<T>*>(this->root_ptr)); }
+
+    // 키를 오름차순으로 f에 넘긴다. 시각화하지 않는다.
+    template <typename F>
+    void forEach(F f) {
+        visitRange(dynamic_cast<RBNode<T>*>(this->root_ptr), nullptr, nullptr, f);
+    }
+    // [begin, end] 안의 키만 오름차순으로 f에 넘긴다. 범위 밖 서브트리는 내려가지 않는다.
+    template <typename F>
+    void forEachInRange(T begin, T end, F f) {
+        visitRange(dynamic_cast<RBNode<T>*>(this->root_ptr), &begin, &end, f);
+    }
 
     // ---------------- Search (BST Style Visualization) ----------------
     bool search(T target) {
@@ -88,44 +104,43 @@ public:
             return false;
         }
 
-        while (current != nullptr) {
-            this->vis->setColor(current, Color::YELLOW);
-            this->vis->setMessage("Comparing " + DataNode<T>::toString(current->key[0]) + " with target " + DataNode<T>::toString(target));
-            this->vis->render();
+        RBNode<T>* last;
+        return descendFrom(current, target, last);
+    }
 
-            if (target == current->key[0]) {
-                this->vis->setColor(current, Color::GREEN);
-                this->vis->setMessage("Target found!");
-                this->vis->render();
-                return true;
-            }
+    // ---------------- Finger Search ----------------
 
-            // 시각화 복구
-            current->syncColor(this->vis);
+    // 마지막으로 도달한 노드를 기억하는 커서. 커서(스레드)마다 하나씩 두고
+    // 가까운 키를 연달아 찾으면 루트 대신 그 노드에서 필요한 만큼만 올라갔다가 내려간다.
+    // remove가 일어나면 version이 바뀌어 다음 탐색은 루트부터 시작한다.
+    struct Finger {
+        RBNode<T>* node = nullptr;
+        long long version = -1;
+    };
 
-            if (target < current->key[0]) {
-                if (current->left() == nullptr) {
-                    this->vis->setColor(current, Color::RED);
-                    this->vis->setMessage("Target < Key, but left child is empty. Not found.");
-                    this->vis->render();
-                    return false;
-                }
-                this->vis->setMessage("Target < Key (" + DataNode<T>::toString(target) + " < " + DataNode<T>::toString(current->key[0]) + ")\n-> Moving Left");
-                this->vis->render();
-                current = current->left();
-            } else {
-                if (current->right() == nullptr) {
-                    this->vis->setColor(current, Color::RED);
-                    this->vis->setMessage("Target > Key, but right child is empty. Not found.");
-                    this->vis->render();
-                    return false;
-                }
-                this->vis->setMessage("Target > Key (" + DataNode<T>::toString(target) + " > " + DataNode<T>::toString(current->key[0]) + ")\n-> Moving Right");
-                this->vis->render();
-                current = current->right();
-            }
+    bool fingerSearch(T target, Finger& finger) {
+        this->vis->clear();
+        this->vis->setTitle("Finger Searching for: " + DataNode<T>::toString(target));
+
+        RBNode<T>* current = dynamic_cast<RBNode<T>*>(this->root_ptr);
+
+        if (current == nullptr) {
+            this->vis->setMessage("Tree is empty.");
+            this->vis->render();
+            return false;
         }
-        return false;
+
+        if (finger.node != nullptr && finger.version == version) {
+            this->vis->setMessage("Starting from finger " + DataNode<T>::toString(finger.node->key[0]));
+            this->vis->render();
+            current = climbToward(finger.node, target);
+        }
+
+        RBNode<T>* last;
+        bool found = descendFrom(current, target, last);
+        finger.node = last;
+        finger.version = version;
+        return found;
     }
 
     // ---------------- Insert (Detailed Visualization) ----------------
@@ -143,6 +158,7 @@ public:
         // BST 삽입 과정 시각화
         while (x != nullptr) {
             y = x;
+            this->stats.visited++;
             this->vis->setColor(x, Color::YELLOW);
             this->vis->setMessage("Comparing " + DataNode<T>::toString(key) + " with " + DataNode<T>::toString(x->key[0]));
             this->vis->render();
@@ -228,6 +244,7 @@ public:
         }
 
         deleteNode(z);
+        version++;
 
         this->vis->clear();
         this->vis->setMessage("Removal Complete.");
@@ -257,13 +274,223 @@ public:
         return found;
     }
 
+    int height() {
+        return heightOf(dynamic_cast<RBNode<T>*>(this->root_ptr));
+    }
+
+    // ---------------- Join-based Set Operations ----------------
+    // 모든 연산은 join(L, k, R) 하나로 트리를 다시 붙인다 (Blelloch et al., "Just Join").
+    // 노드를 복사하지 않고 옮겨 붙이므로 인자로 받은 트리는 연산 후 비게 된다.
+
+    // this의 모든 키 < right의 모든 키일 때만 이어 붙인다. O(log n)
+    bool join(RBTree<T>& right) {
+        this->vis->clear();
+        this->vis->setTitle("Joining two trees");
+
+        RBNode<T>* l = dynamic_cast<RBNode<T>*>(this->root_ptr);
+        RBNode<T>* r = dynamic_cast<RBNode<T>*>(right.root_ptr);
+        if (&right == this || (l && r && !(maximumOf(l)->key[0] < r->minimum()->key[0]))) {
+            this->vis->setMessage("Keys overlap. Join failed.");
+            this->vis->render();
+            return false;
+        }
+
+        SubTree joined = join2(whole(), right.whole());
+        right.adopt(SubTree{});
+        adopt(joined);
+
+        this->vis->setMessage("Join Complete.");
+        this->vis->render();
+        return true;
+    }
+
+    // key 미만은 left로, key 이상은 right로 옮긴다. left/right의 기존 내용은 지워진다. O(log n)
+    bool split(T key, RBTree<T>& left, RBTree<T>& right) {
+        this->vis->clear();
+        this->vis->setTitle("Splitting at: " + DataNode<T>::toString(key));
+
+        SubTree all = whole();
+        this->setRoot(nullptr);
+        freeSubtree(dynamic_cast<RBNode<T>*>(left.root_ptr));
+        freeSubtree(dynamic_cast<RBNode<T>*>(right.root_ptr));
+
+        SubTree l, r;
+        RBNode<T>* mid;
+        splitAt(all, key, l, mid, r);
+        if (mid) r = joinAt(SubTree{}, mid, r);
+
+        version++;
+        left.adopt(l);
+        right.adopt(r);
+
+        this->vis->setMessage("Split Complete.");
+        this->vis->render();
+        return mid != nullptr;
+    }
+
+    void unionWith(RBTree<T>& other) {
+        if (&other == this) return;
+        SubTree result = unite(whole(), other.whole(), parallel_depth);
+        other.adopt(SubTree{});
+        adopt(result);
+        renderResult("Union");
+    }
+
+    void intersectWith(RBTree<T>& other) {
+        if (&other == this) return;
+        SubTree result = intersect(whole(), other.whole(), parallel_depth);
+        other.adopt(SubTree{});
+        adopt(result);
+        renderResult("Intersection");
+    }
+
+    // this에서 other의 키를 뺀다.
+    void differenceWith(RBTree<T>& other) {
+        if (&other == this) return;
+        SubTree result = subtract(whole(), other.whole(), parallel_depth);
+        other.adopt(SubTree{});
+        adopt(result);
+        renderResult("Difference");
+    }
+
+    // 집합 연산의 두 재귀 호출을 fork할 최대 깊이. 0이면 단일 스레드.
+    void setParallelDepth(int depth) { parallel_depth = depth; }
+
+    // ---------------- Snapshot ----------------
+
+    // 노드를 BFS 순서로 path에 쓴다. 읽기는 SnapshotView<T>로 한다 (snapshot.hpp 참고).
+    bool saveSnapshot(const string& path) {
+        this->vis->clear();
+        this->vis->setTitle("Saving snapshot: " + path);
+
+        SnapshotWriter out(path, SnapshotKind::RBTREE, sizeof(T), 0, rbnodeRecordSize(sizeof(T)));
+        vector<RBNode<T>*> queue;
+        if (this->root_ptr) queue.push_back(dynamic_cast<RBNode<T>*>(this->root_ptr));
+
+        for (size_t i = 0; i < queue.size() && out.ok(); i++) {
+            RBNode<T>* x = queue[i];
+            out.begin();
+            RBNode<T>* kids[2] = {x->left(), x->right()};
+            for (int side = 0; side < 2; side++) {
+                if (kids[side] == nullptr) continue;
+                out.put<uint64_t>(8 * side, out.offsetOf(queue.size()));
+                queue.push_back(kids[side]);
+            }
+            out.put<uint32_t>(RBNODE_COLOR_AT, x->rb_color);
+            out.put<T>(RBNODE_KEY_AT, x->key[0]);
+            out.commit(1);
+        }
+
+        bool ok = out.finish();
+        this->vis->setMessage(ok ? "Snapshot saved (" + to_string(queue.size()) + " nodes)." : "Failed to write snapshot.");
+        this->vis->render();
+        return ok;
+    }
+
+protected:
+    // ---------------- Bound (Successor / Predecessor) ----------------
+
+    optional<T> bound(T x, bool greater, bool inclusive) override {
+        return this->template binaryBound<RBNode<T>>(x, greater, inclusive,
+                                                     [this](RBNode<T>* n) { n->syncColor(this->vis); });
+    }
+
 private:
+    long long version = 0; // 노드가 삭제될 때마다 증가 (Finger 무효화용)
+    int parallel_depth = defaultForkDepth();
+
+    // 이보다 낮은 서브트리는 스레드를 띄우는 비용이 더 크므로 fork하지 않는다.
+    static constexpr int fork_min_black_height = 8;
+
+    // 서브트리와 그 검은 높이 (루트가 BLACK이면 루트 포함, nullptr는 0).
+    // 노드에 높이를 저장하지 않는 대신 내려가면서 계산해 넘긴다.
+    struct SubTree {
+        RBNode<T>* root = nullptr;
+        int bh = 0;
+    };
+
+    // start부터 target을 찾아 내려간다. last에는 마지막으로 비교한 노드가 남는다.
+    bool descendFrom(RBNode<T>* current, T target, RBNode<T>*& last) {
+        while (current != nullptr) {
+            last = current;
+            this->stats.visited++;
+            this->vis->setColor(current, Color::YELLOW);
+            this->vis->setMessage("Comparing " + DataNode<T>::toString(current->key[0]) + " with target " + DataNode<T>::toString(target));
+            this->vis->render();
+
+            if (target == current->key[0]) {
+                this->vis->setColor(current, Color::GREEN);
+                this->vis->setMessage("Target found!");
+                this->vis->render();
+                return true;
+            }
+
+            // 시각화 복구
+            current->syncColor(this->vis);
+
+            if (target < current->key[0]) {
+                if (current->left() == nullptr) {
+                    this->vis->setColor(current, Color::RED);
+                    this->vis->setMessage("Target < Key, but left child is empty. Not found.");
+                    this->vis->render();
+                    return false;
+                }
+                this->vis->setMessage("Target < Key (" + DataNode<T>::toString(target) + " < " + DataNode<T>::toString(current->key[0]) + ")\n-> Moving Left");
+                this->vis->render();
+                current = current->left();
+            } else {
+                if (current->right() == nullptr) {
+                    this->vis->setColor(current, Color::RED);
+                    this->vis->setMessage("Target > Key, but right child is empty. Not found.");
+                    this->vis->render();
+                    return false;
+                }
+                this->vis->setMessage("Target > Key (" + DataNode<T>::toString(target) + " > " + DataNode<T>::toString(current->key[0]) + ")\n-> Moving Right");
+                this->vis->render();
+                current = current->right();
+            }
+        }
+        return false;
+    }
+
+    // x의 서브트리가 target을 담을 수 있을 때까지 부모 링크로 올라간다.
+    // target > x이면 x에서 위로 "오른쪽 자식"인 동안 올라간 뒤의 부모가 x 서브트리의 상한이다.
+    // target이 그 상한보다 작으면 x 아래에 있고, 아니면 상한 노드로 옮겨 반복한다.
+    RBNode<T>* climbToward(RBNode<T>* x, T target) {
+        while (target != x->key[0]) {
+            bool go_right = target > x->key[0];
+            RBNode<T>* a = x;
+            while (a->parent != nullptr && a == (go_right ? a->parent->right() : a->parent->left())) {
+                this->stats.visited++;
+                a = a->parent;
+            }
+
+            RBNode<T>* bound = a->parent;
+            if (bound == nullptr) break;
+            this->stats.visited++;
+            if (go_right ? target < bound->key[0] : target > bound->key[0]) break;
+
+            this->vis->setColor(bound, Color::CYAN);
+            this->vis->setMessage("Target is beyond " + DataNode<T>::toString(bound->key[0]) + ".\n-> Climbing up");
+            this->vis->render();
+            bound->syncColor(this->vis);
+            x = bound;
+        }
+        return x;
+    }
+
+    static int heightOf(RBNode<T>* node) {
+        if (node == nullptr) return 0;
+        return 1 + max(heightOf(node->left()), heightOf(node->right()));
+    }
+
     // 탐색 과정을 시각화하며 노드 찾기
     RBNode<T>* findNodeWithVisual(T key) {
         RBNode<T>* current = dynamic_cast<RBNode<T>*>(this->root_ptr);
         this->vis->setMessage("Searching for node to delete...");
         
         while (current != nullptr) {
+            this->stats.visited++;
             this->vis->setColor(current, Color::YELLOW);
             this->vis->render();
 
@@ -290,6 +517,7 @@ private:
         this->vis->setMessage("Left Rotating around " + DataNode<T>::toString(x->key[0]));
         this->vis->render();
 
+        this->stats.rotations++;
         RBNode<T>* y = x->right();
         x->children[1] = y->children[0]; 
 
@@ -320,6 +548,7 @@ private:
         this->vis->setMessage("Right Rotating around " + DataNode<T>::toString(y->key[0]));
         this->vis->render();
 
+        this->stats.rotations++;
         RBNode<T>* x = y->left();
         y->children[0] = x->children[1];
 
@@ -469,15 +698,18 @@ private:
     void deleteNode(RBNode<T>* z) {
         RBNode<T>* y = z;
         RBNode<T>* x;
+        RBNode<T>* x_parent; // x가 null일 수 있으므로 x의 부모를 z 삭제 전에 저장
         RBColor y_original_color = y->rb_color;
 
         if (z->left() == nullptr) {
             x = z->right();
+            x_parent = z->parent;
             this->vis->setMessage("Node has no left child. Replacing with right child.");
             this->vis->render();
             transplant(z, z->right());
         } else if (z->right() == nullptr) {
             x = z->left();
+            x_parent = z->parent;
             this->vis->setMessage("Node has no right child. Replacing with left child.");
             this->vis->render();
             transplant(z, z->left());
@@ -494,8 +726,10 @@ private:
             this->vis->render();
 
             if (y->parent == z) {
+                x_parent = y;
                 if (x) x->parent = y; 
             } else {
+                x_parent = y->parent;
                 transplant(y, y->right());
                 y->setRight(z->right());
             }
@@ -514,36 +748,8 @@ private:
         if (y_original_color == BLACK) {
             this->vis->setMessage("Deleted node (or moved successor) was BLACK.\nPossible Double Black violation. Calling Delete Fixup.");
             this->vis->render();
-            
-            // x가 null일 경우를 대비해 부모 포인터를 추적
-            RBNode<T>* x_parent = nullptr;
-            if (x) x_parent = x->parent;
-            else {
-                // transplant나 로직에 의해 x의 부모가 될 노드 찾기
-                if (y->parent == z) x_parent = y; // y가 z의 직계 자식이었던 경우
-                else x_parent = y->parent; // y가 z의 오른쪽 서브트리 어딘가에 있었던 경우
-                
-                // Case where z had < 2 children (y==z)
-                if (y == z) {
-                     // z가 삭제되었으므로 z의 부모가 x의 부모
-                     // z는 이미 delete 되었으므로 접근 불가하지만, transplant 호출 시 z->parent는 x->parent가 됨
-                     // 여기서는 delete z 전에 저장해 두거나, transplant 로직을 고려해야 함.
-                     // 하지만 위 코드에서 이미 delete z 됨.
-                     // deleteNode 함수 내 변수 z는 포인터이므로 delete 후 접근 위험.
-                     // 사실 transplant가 실행되면 z의 부모의 자식 포인터는 이미 변경됨.
-                     // 정확한 x_parent를 위해선 delete 전에 저장했어야 함.
-                     // 하지만 여기서는 간단히 y==z인 경우(자식이 0~1개)는 transplant가 처리함.
-                }
-            }
-            
-            // Note: x가 null일 때 부모를 정확히 찾기 위해선 로직 보강이 필요하지만,
-            // 시각화 목적상 x가 있는 경우 위주로 설명하거나,
-            // x가 없더라도(leaf 삭제) Double Black 해결 과정을 보여주기 위해
-            // x_parent 변수를 deleteFixup에 전달하도록 수정.
-            
-            // 이 예제 코드에서는 x가 유효하거나 루트가 아닌 경우를 가정하고 진행합니다.
-            // 실제 완전한 구현에서는 Null Node(Sentinel)를 사용하는 것이 일반적입니다.
-            if (x != nullptr || (x_parent != nullptr)) {
+
+            if (x != nullptr || x_parent != nullptr) {
                 deleteFixup(x, x_parent);
             }
         }
@@ -660,6 +866,230 @@ private:
         this->vis->render();
     }
 
+    // ---------------- Join Helpers ----------------
+
+    static bool isRed(RBNode<T>* node) { return node != nullptr && node->rb_color == RED; }
+
+    static RBNode<T>* link(RBNode<T>* node, RBNode<T>* l, RBNode<T>* r) {
+        node->children[0] = l;
+        node->children[1] = r;
+        node->children_count = (l != nullptr) + (r != nullptr);
+        if (l) l->parent = node;
+        if (r) r->parent = node;
+        return node;
+    }
+
+    static RBNode<T>* maximumOf(RBNode<T>* node) {
+        while (node->right() != nullptr) node = node->right();
+        return node;
+    }
+
+    static int blackHeightOf(RBNode<T>* node) {
+        int bh = 0;
+        for (; node != nullptr; node = node->left())
+            if (node->rb_color == BLACK) bh++;
+        return bh;
+    }
+
+    static SubTree leftOf(const SubTree& t) { return SubTree{t.root->left(), t.bh - (isRed(t.root) ? 0 : 1)}; }
+    static SubTree rightOf(const SubTree& t) { return SubTree{t.root->right(), t.bh - (isRed(t.root) ? 0 : 1)}; }
+
+    SubTree whole() {
+        RBNode<T>* root = dynamic_cast<RBNode<T>*>(this->root_ptr);
+        return SubTree{root, blackHeightOf(root)};
+    }
+
+    void adopt(SubTree t) {
+        if (t.root) {
+            t.root->parent = nullptr;
+            t.root->rb_color = BLACK;
+        }
+        this->setRoot(t.root);
+        version++;
+    }
+
+    void renderResult(const string& op) {
+        this->vis->clear();
+        this->vis->setTitle(op + " Complete.");
+        this->vis->render();
+    }
+
+    // l의 오른쪽 경계를 따라 r과 검은 높이가 같은 BLACK 노드까지 내려가 m을 RED로 끼운다.
+    // 돌아오면서 RED-RED가 생기면 한 번 회전해 위로 넘긴다.
+    static RBNode<T>* joinRight(RBNode<T>* l, int hl, RBNode<T>* m, RBNode<T>* r, int hr) {
+        if (!isRed(l) && hl == hr) {
+            m->rb_color = RED;
+            return link(m, l, r);
+        }
+        RBNode<T>* c = joinRight(l->right(), hl - (isRed(l) ? 0 : 1), m, r, hr);
+        link(l, l->left(), c);
+        if (!isRed(l) && isRed(c) && isRed(c->right())) {
+            c->right()->rb_color = BLACK;
+            link(l, l->left(), c->left());
+            return link(c, l, c->right());
+        }
+        return l;
+    }
+
+    static RBNode<T>* joinLeft(RBNode<T>* l, int hl, RBNode<T>* m, RBNode<T>* r, int hr) {
+        if (!isRed(r) && hr == hl) {
+            m->rb_color = RED;
+            return link(m, l, r);
+        }
+        RBNode<T>* c = joinLeft(l, hl, m, r->left(), hr - (isRed(r) ? 0 : 1));
+        link(r, c, r->right());
+        if (!isRed(r) && isRed(c) && isRed(c->left())) {
+            c->left()->rb_color = BLACK;
+            link(r, c->right(), r->right());
+            return link(c, c->left(), r);
+        }
+        return r;
+    }
+
+    // l의 모든 키 < m < r의 모든 키. O(|검은 높이 차| + 1)
+    static SubTree joinAt(SubTree l, RBNode<T>* m, SubTree r) {
+        if (isRed(l.root)) { l.root->rb_color = BLACK; l.bh++; }
+        if (isRed(r.root)) { r.root->rb_color = BLACK; r.bh++; }
+
+        SubTree t;
+        if (l.bh > r.bh) {
+            t = SubTree{joinRight(l.root, l.bh, m, r.root, r.bh), l.bh};
+            if (isRed(t.root) && isRed(t.root->right())) { t.root->rb_color = BLACK; t.bh++; }
+        } else if (r.bh > l.bh) {
+            t = SubTree{joinLeft(l.root, l.bh, m, r.root, r.bh), r.bh};
+            if (isRed(t.root) && isRed(t.root->left())) { t.root->rb_color = BLACK; t.bh++; }
+        } else {
+            m->rb_color = RED;
+            t = SubTree{link(m, l.root, r.root), l.bh};
+        }
+        t.root->parent = nullptr;
+        return t;
+    }
+
+    // t에서 최대 키 노드를 떼어 last로 돌려준다.
+    static SubTree splitLast(SubTree t, RBNode<T>*& last) {
+        if (t.root->right() == nullptr) {
+            last = t.root;
+            return leftOf(t);
+        }
+        SubTree rest = splitLast(rightOf(t), last);
+        return joinAt(leftOf(t), t.root, rest);
+    }
+
+    // 가운데 키 없이 이어 붙인다.
+    static SubTree join2(SubTree l, SubTree r) {
+        if (l.root == nullptr) return r;
+        if (r.root == nullptr) return l;
+        RBNode<T>* last;
+        SubTree rest = splitLast(l, last);
+        return joinAt(rest, last, r);
+    }
+
+    // t를 key 미만(l)과 초과(r)로 나눈다. key 노드가 있으면 mid로 떼어낸다.
+    static void splitAt(SubTree t, T key, SubTree& l, RBNode<T>*& mid, SubTree& r) {
+        if (t.root == nullptr) {
+            l = r = SubTree{};
+            mid = nullptr;
+            return;
+        }
+        RBNode<T>* node = t.root;
+        if (key == node->key[0]) {
+            l = leftOf(t);
+            r = rightOf(t);
+            mid = node;
+        } else if (key < node->key[0]) {
+            SubTree rest;
+            splitAt(leftOf(t), key, l, mid, rest);
+            r = joinAt(rest, node, rightOf(t));
+        } else {
+            SubTree rest;
+            splitAt(rightOf(t), key, rest, mid, r);
+            l = joinAt(leftOf(t), node, rest);
+        }
+    }
+
+    static int forkDepth(int depth, const SubTree& t) {
+        return t.bh >= fork_min_black_height ? depth : 0;
+    }
+
+    // b의 루트 키로 a를 나누고 양쪽을 각각 재귀로 합친 뒤 그 키로 다시 join한다.
+    // 두 재귀 호출은 서로 다른 노드만 건드리므로 병렬로 돌릴 수 있다.
+    static SubTree unite(SubTree a, SubTree b, int depth) {
+        if (a.root == nullptr) return b;
+        if (b.root == nullptr) return a;
+
+        SubTree al, ar, l, r;
+        RBNode<T>* mid;
+        splitAt(a, b.root->key[0], al, mid, ar);
+        delete mid;
+
+        SubTree bl = leftOf(b), br = rightOf(b);
+        forkJoin(forkDepth(depth, b),
+                 [&] { l = unite(al, bl, depth - 1); },
+                 [&] { r = unite(ar, br, depth - 1); });
+        return joinAt(l, b.root, r);
+    }
+
+    static SubTree intersect(SubTree a, SubTree b, int depth) {
+        if (a.root == nullptr || b.root == nullptr) {
+            freeSubtree(a.root);
+            freeSubtree(b.root);
+            return SubTree{};
+        }
+
+        SubTree al, ar, l, r;
+        RBNode<T>* mid;
+        splitAt(a, b.root->key[0], al, mid, ar);
+
+        SubTree bl = leftOf(b), br = rightOf(b);
+        forkJoin(forkDepth(depth, b),
+                 [&] { l = intersect(al, bl, depth - 1); },
+                 [&] { r = intersect(ar, br, depth - 1); });
+
+        delete b.root;
+        return mid ? joinAt(l, mid, r) : join2(l, r);
+    }
+
+    static SubTree subtract(SubTree a, SubTree b, int depth) {
+        if (a.root == nullptr) {
+            freeSubtree(b.root);
+            return SubTree{};
+        }
+        if (b.root == nullptr) return a;
+
+        SubTree al, ar, l, r;
+        RBNode<T>* mid;
+        splitAt(a, b.root->key[0], al, mid, ar);
+        delete mid;
+
+        SubTree bl = leftOf(b), br = rightOf(b);
+        forkJoin(forkDepth(depth, b),
+                 [&] { l = subtract(al, bl, depth - 1); },
+                 [&] { r = subtract(ar, br, depth - 1); });
+
+        delete b.root;
+        return join2(l, r);
+    }
+
+    static void freeSubtree(RBNode<T>* node) {
+        if (node == nullptr) return;
+        freeSubtree(node->left());
+        freeSubtree(node->right());
+        delete node;
+    }
+
+    // lo/hi가 nullptr이면 그쪽으로는 제한이 없다.
+    template <typename F>
+    static void visitRange(RBNode<T>* node, const T* lo, const T* hi, F& f) {
+        if (node == nullptr) return;
+        const T& k = node->key[0];
+        bool above = lo == nullptr || !(k < *lo);
+        bool below = hi == nullptr || !(*hi < k);
+        if (above) visitRange(node->left(), lo, hi, f);
+        if (above && below) f(k);
+        if (below) visitRange(node->right(), lo, hi, f);
+    }
+
     // Range Search Recursive (동일)
     void rangeSearchRecursive(RBNode<T>* node, T begin, T end, bool& found) {
         if (node == nullptr) return;
@@ -0,0 +1,296 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <optional>
+#include <fstream>
+#include <algorithm>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// 트리 스냅샷 파일 형식
+//   [SnapshotHeader][노드 레코드 0][노드 레코드 1]...
+// 노드는 루트부터 BFS 순서로 쓰고, 자식은 포인터 대신 파일 시작 기준 바이트 오프셋으로 가리킨다 (0 = 없음).
+// 한 파일 안에서 레코드 크기는 고정이므로 SnapshotView는 역직렬화 없이 매핑된 메모리를 그대로 따라간다.
+// 키는 메모리 표현 그대로 쓰므로 같은 엔디언, 같은 sizeof(T)에서만 읽을 수 있다 (헤더로 확인).
+//
+// BTree / BPlusTree 레코드 (B+ 리프의 tombstone 키는 빼고 쓴다)
+//   uint32 key_count | uint32 leaf | uint64 next (B+ 리프 체인) | uint64 child[2t] | T key[2t-1]
+// RBTree 레코드
+//   uint64 left | uint64 right | uint32 color | uint32 (pad) | T key
+
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+enum class SnapshotKind : uint32_t { BTREE = 1, BPLUSTREE = 2, RBTREE = 3 };
+
+struct SnapshotHeader {
+    char magic[8];         // "TVIZSNAP"
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t kind;         // SnapshotKind
+    uint32_t key_size;     // sizeof(T)
+    uint32_t degree;       // B/B+ 트리의 최소 차수 t (RBTree는 0)
+    uint32_t record_size;  // 노드 레코드 하나의 바이트 수 (8의 배수)
+    uint64_t node_count;
+    uint64_t key_count;
+    uint64_t root;         // 루트 레코드 오프셋 (빈 트리는 0)
+};
+
+// B/B+ 레코드 안의 위치
+const uint32_t BNODE_CHILDREN_AT = 16;
+inline uint32_t bnodeKeysAt(uint32_t t) { return BNODE_CHILDREN_AT + 8 * (2 * t); }
+inline uint32_t bnodeRecordSize(uint32_t t, uint32_t key_size) {
+    return (bnodeKeysAt(t) + key_size * (2 * t - 1) + 7) / 8 * 8;
+}
+
+// RB 레코드 안의 위치
+const uint32_t RBNODE_COLOR_AT = 16;
+const uint32_t RBNODE_KEY_AT = 24;
+inline uint32_t rbnodeRecordSize(uint32_t key_size) { return (RBNODE_KEY_AT + key_size + 7) / 8 * 8; }
+
+// 레코드를 BFS 순서대로 이어 쓰고 마지막에 헤더를 채운다.
+// 노드 i의 오프셋은 offsetOf(i)이므로 자식은 큐에 넣는 순간 오프셋이 정해진다.
+class SnapshotWriter {
+public:
+    SnapshotWriter(const string& path, SnapshotKind kind, uint32_t key_size, uint32_t degree, uint32_t record_size)
+        : out(path, ios::binary | ios::trunc), record(record_size) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "TVIZSNAP", 8);
+        header.version = SNAPSHOT_VERSION;
+        header.byte_order = SNAPSHOT_BYTE_ORDER;
+        header.kind = static_cast<uint32_t>(kind);
+        header.key_size = key_size;
+        header.degree = degree;
+        header.record_size = record_size;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    bool ok() const { return bool(out); }
+
+    uint64_t offsetOf(uint64_t index) const { return sizeof(SnapshotHeader) + index * header.record_size; }
+
+    // 새 레코드를 0으로 비우고 그 버퍼를 돌려준다.
+    char* begin() {
+        fill(record.begin(), record.end(), 0);
+        return record.data();
+    }
+
+    template <typename U>
+    void put(uint32_t at, const U& value) { memcpy(record.data() + at, &value, sizeof(U)); }
+
+    void commit(uint64_t keys) {
+        out.write(record.data(), record.size());
+        header.node_count++;
+        header.key_count += keys;
+    }
+
+    bool finish() {
+        header.root = header.node_count > 0 ? offsetOf(0) : 0;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        return bool(out);
+    }
+
+private:
+    ofstream out;
+    SnapshotHeader header;
+    vector<char> record;
+};
+
+// 스냅샷 파일을 mmap해 읽기 전용 조회를 매핑 위에서 바로 처리한다.
+// 열 때 헤더와 파일 크기만 검사하고, 노드는 조회할 때 필요한 페이지만 읽힌다.
+// 깨진 파일이라도 매핑 밖은 읽지 않는다: 레코드 크기는 차수로 검사하고, 오프셋은 inRange로,
+// 레코드의 key_count는 2t-1로 잘라 읽는다.
+template <typename T>
+class SnapshotView {
+    static_assert(is_trivially_copyable<T>::value, "snapshot keys must be trivially copyable");
+
+public:
+    SnapshotView() {}
+    ~SnapshotView() { close(); }
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+
+    bool open(const string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SnapshotHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+
+        base = static_cast<const char*>(mapped);
+        length = st.st_size;
+        memcpy(&header, base, sizeof(header));
+
+        bool valid = memcmp(header.magic, "TVIZSNAP", 8) == 0
+            && header.version == SNAPSHOT_VERSION
+            && header.byte_order == SNAPSHOT_BYTE_ORDER
+            && header.key_size == sizeof(T)
+            && header.kind >= 1 && header.kind <= 3
+            && header.record_size >= minRecordSize()
+            // node_count * record_size가 넘치지 않도록 나눗셈으로 비교한다.
+            && (length - sizeof(SnapshotHeader)) % header.record_size == 0
+            && (length - sizeof(SnapshotHeader)) / header.record_size == header.node_count
+            && (header.root == 0 ? header.node_count == 0 : inRange(header.root));
+        if (!valid) close();
+        return valid;
+    }
+
+    void close() {
+        if (base) munmap(const_cast<char*>(base), length);
+        base = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    SnapshotKind kind() const { return static_cast<SnapshotKind>(header.kind); }
+    uint64_t size() const { return header.key_count; }
+
+    bool search(T k) const {
+        optional<T> found = lowerBound(k);
+        return found && *found == k;
+    }
+
+    // k 이상인 최소 키
+    optional<T> lowerBound(T k) const {
+        if (!isOpen()) return nullopt;
+        if (kind() == SnapshotKind::RBTREE) return rbLowerBound(k);
+        if (kind() == SnapshotKind::BPLUSTREE) return bplusLowerBound(k);
+        return btreeLowerBound(k);
+    }
+
+    // 모든 키를 오름차순으로 f에 넘긴다.
+    template <typename F>
+    void forEach(F f) const {
+        if (!isOpen() || header.root == 0) return;
+        if (kind() == SnapshotKind::BPLUSTREE) {
+            uint64_t leaf = header.root;
+            while (!isLeaf(leaf)) leaf = child(leaf, 0);
+            for (; leaf != 0; leaf = next(leaf))
+                for (uint32_t i = 0; i < keyCount(leaf); i++) f(bkey(leaf, i));
+        } else {
+            inorder(header.root, f);
+        }
+    }
+
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+    SnapshotHeader header;
+
+    bool inRange(uint64_t off) const {
+        return off >= sizeof(SnapshotHeader) && off <= length && length - off >= header.record_size;
+    }
+
+    // 헤더의 종류/차수로 필요한 레코드 크기 (64비트로 계산해 큰 차수에서도 넘치지 않는다)
+    uint64_t minRecordSize() const {
+        if (kind() == SnapshotKind::RBTREE) return rbnodeRecordSize(header.key_size);
+        if (header.degree < 1) return UINT64_MAX;
+        uint64_t t = header.degree;
+        return (BNODE_CHILDREN_AT + 8 * (2 * t) + uint64_t(header.key_size) * (2 * t - 1) + 7) / 8 * 8;
+    }
+
+    template <typename U>
+    U load(uint64_t off, uint32_t at) const {
+        U value;
+        memcpy(&value, base + off + at, sizeof(U));
+        return value;
+    }
+
+    uint32_t keyCount(uint64_t off) const { return min(load<uint32_t>(off, 0), 2 * header.degree - 1); }
+    bool isLeaf(uint64_t off) const { return load<uint32_t>(off, 4) != 0; }
+    uint64_t next(uint64_t off) const {
+        uint64_t n = load<uint64_t>(off, 8);
+        return inRange(n) ? n : 0;
+    }
+    uint64_t child(uint64_t off, uint32_t i) const {
+        uint64_t c = load<uint64_t>(off, BNODE_CHILDREN_AT + 8 * i);
+        return inRange(c) ? c : 0;
+    }
+    T bkey(uint64_t off, uint32_t i) const { return load<T>(off, bnodeKeysAt(header.degree) + sizeof(T) * i); }
+
+    uint64_t rbChild(uint64_t off, int side) const {
+        uint64_t c = load<uint64_t>(off, 8 * side);
+        return inRange(c) ? c : 0;
+    }
+    T rbKey(uint64_t off) const { return load<T>(off, RBNODE_KEY_AT); }
+
+    optional<T> btreeLowerBound(T k) const {
+        optional<T> best;
+        for (uint64_t x = header.root; x != 0;) {
+            uint32_t n = keyCount(x), i = 0;
+            while (i < n && bkey(x, i) < k) i++;
+            if (i < n) {
+                best = bkey(x, i);
+                if (*best == k) return best;
+            }
+            if (isLeaf(x)) break;
+            x = child(x, i);
+        }
+        return best;
+    }
+
+    optional<T> bplusLowerBound(T k) const {
+        uint64_t x = header.root;
+        if (x == 0) return nullopt;
+        while (!isLeaf(x)) {
+            uint32_t n = keyCount(x), i = 0;
+            while (i < n && k >= bkey(x, i)) i++;
+            x = child(x, i);
+            if (x == 0) return nullopt;
+        }
+        for (; x != 0; x = next(x)) {
+            uint32_t n = keyCount(x);
+            for (uint32_t i = 0; i < n; i++)
+                if (!(bkey(x, i) < k)) return bkey(x, i);
+        }
+        return nullopt;
+    }
+
+    optional<T> rbLowerBound(T k) const {
+        optional<T> best;
+        for (uint64_t x = header.root; x != 0;) {
+            T key = rbKey(x);
+            if (key == k) return key;
+            if (k < key) {
+                best = key;
+                x = rbChild(x, 0);
+            } else {
+                x = rbChild(x, 1);
+            }
+        }
+        return best;
+    }
+
+    template <typename F>
+    void inorder(uint64_t x, F& f) const {
+        if (x == 0) return;
+        if (kind() == SnapshotKind::RBTREE) {
+            inorder(rbChild(x, 0), f);
+            f(rbKey(x));
+            inorder(rbChild(x, 1), f);
+            return;
+        }
+        uint32_t n = keyCount(x);
+        for (uint32_t i = 0; i < n; i++) {
+            if (!isLeaf(x)) inorder(child(x, i), f);
+            f(bkey(x, i));
+        }
+        if (!isLeaf(x)) inorder(child(x, n), f);
+    }
+};
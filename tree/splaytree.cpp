@@ -0,0 +1,25 @@
+#include <iostream>
+#include "splaytree.hpp"
+
+using namespace std;
+
+int main() {
+    VisualizerConfig::setDelayDuration(chrono::milliseconds{500});
+    SplayTree<int> t;
+
+    for (int i = 0; i < 8; i++)
+        t.insert(i);
+
+    t.search(0);
+    t.search(0);
+    t.search(5);
+    t.search(99);
+
+    t.remove(5);
+    t.remove(0);
+    t.remove(99);
+
+    t.rangeSearch(2, 4);
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "tree.hpp"
+#include "node.hpp"
+#include "../visualizer/visualizer.hpp"
+
+template <typename T> class SplayTree;
+
+template <typename T>
+class SplayNode : public DataNode<T> {
+public:
+    SplayNode(T k);
+
+    SplayNode<T>* left() { return static_cast<SplayNode<T>*>(this->children[0]); }
+    SplayNode<T>* right() { return static_cast<SplayNode<T>*>(this->children[1]); }
+    void setLeft(SplayNode<T>* node);
+    void setRight(SplayNode<T>* node);
+
+    void rangeSearch(T begin, T end, Visualizer &vis, bool &found_any);
+
+    void draw(Visualizer& vis);
+
+    friend class SplayTree<T>;
+};
+
+// 접근한 키를 top-down splay로 루트까지 끌어올리는 트리.
+// 자주 찾는 키일수록 루트 가까이에 머문다.
+template <typename T>
+class SplayTree : public DataTree<T> {
+public:
+    bool search(T target);
+    bool insert(T entry);
+    bool remove(T target);
+    bool rangeSearch(T begin, T end);
+
+protected:
+    optional<T> bound(T x, bool greater, bool inclusive) override;
+
+private:
+    SplayNode<T>* splay(SplayNode<T>* t, T k);
+};
+
+template <typename T>
+SplayNode<T>::SplayNode(T k) {
+    this->key.resize(1);
+    this->key[0] = k;
+    this->key_count = 1;
+    this->children.resize(2, nullptr);
+    this->children_count = 0;
+}
+
+template <typename T>
+void SplayNode<T>::setLeft(SplayNode<T>* node) {
+    this->children[0] = node;
+    this->children_count = (this->children[0] != nullptr) + (this->children[1] != nullptr);
+}
+
+template <typename T>
+void SplayNode<T>::setRight(SplayNode<T>* node) {
+    this->children[1] = node;
+    this->children_count = (this->children[0] != nullptr) + (this->children[1] != nullptr);
+}
+
+template <typename T>
+void SplayNode<T>::rangeSearch(T begin, T end, Visualizer& vis, bool& found_any) {
+    vis.setColor(this, Color::YELLOW);
+    vis.setMessage("Visiting " + this->toString(this->key[0]));
+    vis.render();
+
+    T val = this->key[0];
+    bool in_range = (val >= begin && val <= end);
+
+    if (val > begin && left() != nullptr) {
+        vis.setMessage("Key > Begin (" + this->toString(begin) + ")\n-> Exploring Left.");
+        vis.render();
+        left()->rangeSearch(begin, end, vis, found_any);
+    }
+
+    if (in_range) {
+        vis.setColor(this, Color::GREEN);
+        vis.setMessage(this->toString(val) + " is in range [" + this->toString(begin) + ", " + this->toString(end) + "]");
+        found_any = true;
+    } else {
+        vis.setColor(this, Color::RESET);
+        vis.setMessage(this->toString(val) + " is out of range.");
+    }
+    vis.render();
+
+    if (val < end && right() != nullptr) {
+        vis.setMessage("Key < End (" + this->toString(end) + ")\n-> Exploring Right.");
+        vis.render();
+        right()->rangeSearch(begin, end, vis, found_any);
+    }
+}
+
+template <typename T>
+void SplayNode<T>::draw(Visualizer& vis) {
+    if (this->children[1]) {
+        vis.printChild(this->children[1], Pos::UP, this, Pos::UP);
+    }
+    vis.printKey(Pos::MID_NORM, this->toString(this->key[0]), this, 0);
+    if (this->children[0]) {
+        vis.printChild(this->children[0], Pos::DOWN, this, Pos::DOWN);
+    }
+}
+
+// Sleator-Tarjan top-down splay.
+// 내려가면서 k보다 작은 노드는 왼쪽 트리(L)에, 큰 노드는 오른쪽 트리(R)에 붙이고,
+// zig-zig일 때만 한 번 회전한다. 마지막에 L, 멈춘 노드, R을 다시 조립한다.
+template <typename T>
+SplayNode<T>* SplayTree<T>::splay(SplayNode<T>* t, T k) {
+    SplayNode<T> header{k};
+    SplayNode<T>* l = &header; // L의 최댓값 (오른쪽 자식 자리가 비어 있음)
+    SplayNode<T>* r = &header; // R의 최솟값 (왼쪽 자식 자리가 비어 있음)
+
+    while (true) {
+        this->stats.visited++;
+        if (k < t->key[0]) {
+            if (t->left() == nullptr) break;
+            if (k < t->left()->key[0]) {
+                this->stats.visited++;
+                SplayNode<T>* y = t->left();
+                t->setLeft(y->right());
+                y->setRight(t);
+                t = y;
+                this->stats.rotations++;
+                if (t->left() == nullptr) break;
+            }
+            r->setLeft(t);
+            r = t;
+            t = t->left();
+        } else if (k > t->key[0]) {
+            if (t->right() == nullptr) break;
+            if (k > t->right()->key[0]) {
+                this->stats.visited++;
+                SplayNode<T>* y = t->right();
+                t->setRight(y->left());
+                y->setLeft(t);
+                t = y;
+                this->stats.rotations++;
+                if (t->right() == nullptr) break;
+            }
+            l->setRight(t);
+            l = t;
+            t = t->right();
+        } else {
+            break;
+        }
+    }
+
+    l->setRight(t->left());
+    r->setLeft(t->right());
+    t->setLeft(header.right());
+    t->setRight(header.left());
+    return t;
+}
+
+template <typename T>
+bool SplayTree<T>::search(T target) {
+    this->vis->clear();
+    this->vis->setTitle("Searching for target: " + DataNode<T>::toString(target));
+
+    if (this->root_ptr == nullptr) {
+        this->vis->setMessage("Tree is empty.");
+        this->vis->render();
+        return false;
+    }
+
+    this->vis->setMessage("Splaying " + DataNode<T>::toString(target) + " toward the root.");
+    this->vis->render();
+
+    SplayNode<T>* root = splay(static_cast<SplayNode<T>*>(this->root_ptr), target);
+    this->setRoot(root);
+
+    bool found = (root->key[0] == target);
+    if (found) {
+        this->vis->setColor(root, Color::GREEN);
+        this->vis->setMessage("Found target! It is now the root.");
+    } else {
+        this->vis->setColor(root, Color::RED);
+        this->vis->setMessage("Target not found.\nLast visited key " + DataNode<T>::toString(root->key[0]) + " is now the root.");
+    }
+    this->vis->render();
+    return found;
+}
+
+template <typename T>
+bool SplayTree<T>::insert(T entry) {
+    this->vis->clear();
+    this->vis->setTitle("Inserting entry: " + DataNode<T>::toString(entry));
+    this->vis->render();
+
+    if (this->root_ptr == nullptr) {
+        this->vis->setMessage("Tree is empty. \nSetting " + DataNode<T>::toString(entry) + " as the root.");
+        this->setRoot(new SplayNode<T>{entry});
+        this->vis->setColor(this->root_ptr, Color::GREEN);
+        this->vis->render();
+        return true;
+    }
+
+    SplayNode<T>* root = splay(static_cast<SplayNode<T>*>(this->root_ptr), entry);
+    this->setRoot(root);
+
+    if (root->key[0] == entry) {
+        this->vis->setMessage("Entry " + DataNode<T>::toString(entry) + " already exists. Insertion failed.");
+        this->vis->setColor(root, Color::RED);
+        this->vis->render();
+        return false;
+    }
+
+    this->vis->setMessage("Splayed neighbour " + DataNode<T>::toString(root->key[0]) + " to the root.\nSplitting it around the new entry.");
+    this->vis->setColor(root, Color::CYAN);
+    this->vis->render();
+
+    SplayNode<T>* node = new SplayNode<T>{entry};
+    if (entry < root->key[0]) {
+        node->setLeft(root->left());
+        node->setRight(root);
+        root->setLeft(nullptr);
+    } else {
+        node->setRight(root->right());
+        node->setLeft(root);
+        root->setRight(nullptr);
+    }
+    this->setRoot(node);
+
+    this->vis->setColor(root, Color::RESET);
+    this->vis->setColor(node, Color::GREEN);
+    this->vis->setMessage("New root node " + DataNode<T>::toString(entry) + " created.");
+    this->vis->render();
+    return true;
+}
+
+template <typename T>
+bool SplayTree<T>::remove(T target) {
+    this->vis->clear();
+    this->vis->setTitle("Removing target: " + DataNode<T>::toString(target));
+    this->vis->render();
+
+    if (this->root_ptr == nullptr) {
+        this->vis->setMessage("Tree is empty. Cannot remove.");
+        this->vis->render();
+        return false;
+    }
+
+    SplayNode<T>* root = splay(static_cast<SplayNode<T>*>(this->root_ptr), target);
+    this->setRoot(root);
+
+    if (root->key[0] != target) {
+        this->vis->setMessage("Target not found.");
+        this->vis->setColor(root, Color::RED);
+        this->vis->render();
+        return false;
+    }
+
+    this->vis->setMessage("Target splayed to the root. Removing.");
+    this->vis->setColor(root, Color::MAGENTA);
+    this->vis->render();
+
+    SplayNode<T>* new_root;
+    if (root->left() == nullptr) {
+        new_root = root->right();
+    } else {
+        // 왼쪽 서브트리의 최댓값이 루트로 올라오므로 오른쪽 자식 자리가 빈다.
+        new_root = splay(root->left(), target);
+        new_root->setRight(root->right());
+    }
+    delete root;
+    this->setRoot(new_root);
+
+    this->vis->clear();
+    this->vis->setMessage("Removal operation finished.");
+    this->vis->render();
+    return true;
+}
+
+// x를 splay하면 루트는 x이거나 x와 맞닿은 키가 된다.
+// 루트가 답이 아니면 답은 루트의 in-order 이웃, 즉 반대쪽 서브트리의 끝 노드다.
+template <typename T>
+optional<T> SplayTree<T>::bound(T x, bool greater, bool inclusive) {
+    this->vis->clear();
+    this->vis->setTitle(this->boundTitle(greater, inclusive) + " of: " + DataNode<T>::toString(x));
+
+    if (this->root_ptr == nullptr) {
+        this->vis->setMessage("Tree is empty.");
+        this->vis->render();
+        return nullopt;
+    }
+
+    SplayNode<T>* root = splay(static_cast<SplayNode<T>*>(this->root_ptr), x);
+    this->setRoot(root);
+
+    T k = root->key[0];
+    SplayNode<T>* result = nullptr;
+    if ((inclusive && k == x) || (greater ? k > x : k < x)) {
+        result = root;
+    } else {
+        result = greater ? root->right() : root->left();
+        while (result != nullptr) {
+            this->stats.visited++;
+            SplayNode<T>* next = greater ? result->left() : result->right();
+            if (next == nullptr) break;
+            result = next;
+        }
+    }
+
+    if (result == nullptr) {
+        this->vis->setMessage("No such key.");
+        this->vis->render();
+        return nullopt;
+    }
+    this->vis->setColor(result, Color::GREEN);
+    this->vis->setMessage("Result: " + DataNode<T>::toString(result->key[0]));
+    this->vis->render();
+    return result->key[0];
+}
+
+template <typename T>
+bool SplayTree<T>::rangeSearch(T begin, T end) {
+    this->vis->clear();
+    this->vis->setTitle("Range Search [" + DataNode<T>::toString(begin) + " ~ " + DataNode<T>::toString(end) + "]");
+    this->vis->render();
+
+    if (this->root_ptr == nullptr) {
+        this->vis->setMessage("Tree is empty.");
+        this->vis->render();
+        return false;
+    }
+
+    bool found_any = false;
+    static_cast<SplayNode<T>*>(this->root_ptr)->rangeSearch(begin, end, *(this->vis), found_any);
+
+    if (found_any) {
+        this->vis->setMessage("Range search finished.\nGreen nodes are in the range.");
+    } else {
+        this->vis->setMessage("Range search finished.\nNo nodes found in the range.");
+    }
+    this->vis->render();
+    return found_any;
+}
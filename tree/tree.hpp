@@ -1,5 +1,7 @@
 #pragma once
 #include <chrono>
+#include <optional>
+#include <string>
 
 class Node;
 
@@ -8,15 +10,26 @@ class Visualizer;
 
 class Tree {
 public:
-    virtual ~Tree() {};
+    Tree() {}
+    // vis를 소유하므로 복사하지 않는다.
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+    // vis를 지운다. Visualizer가 완전한 타입이어야 하므로 정의는 visualizer.hpp에 있다.
+    virtual ~Tree();
 
     Node* root() { return root_ptr; };
 
 protected:
-    Visualizer* vis;
+    Visualizer* vis = nullptr;
     Node* root_ptr = nullptr;
 };
 
+// 성능 비교용 카운터
+struct TreeStats {
+    long long visited = 0;   // 연산 중 방문한 노드 수
+    long long rotations = 0; // 균형을 맞추기 위한 회전 수
+};
+
 template <typename T>
 class DataTree : public Tree {
 public:
@@ -30,6 +43,32 @@ public:
     virtual bool search(T target) = 0;
     virtual bool remove(T target) = 0;
     virtual bool rangeSearch(T begin, T end) = 0;
+
+    // 한 번의 하강으로 x 주변의 키를 찾는다. 해당 키가 없으면 nullopt.
+    std::optional<T> lowerBound(T x) { return bound(x, true, true); }   // x 이상인 최소 키
+    std::optional<T> upperBound(T x) { return bound(x, true, false); }  // x 초과인 최소 키
+    std::optional<T> successor(T x) { return bound(x, true, false); }
+    std::optional<T> predecessor(T x) { return bound(x, false, false); } // x 미만인 최대 키
+
+    const TreeStats& getStats() const { return stats; }
+    void resetStats() { stats = TreeStats{}; }
+
+protected:
+    TreeStats stats;
+
+    // greater면 x보다 큰 쪽, 아니면 작은 쪽에서 가장 가까운 키. inclusive면 x 자신도 답이 된다.
+    virtual std::optional<T> bound(T x, bool greater, bool inclusive) = 0;
+
+    static std::string boundTitle(bool greater, bool inclusive) {
+        if (greater) return inclusive ? "Lower Bound" : "Successor";
+        return inclusive ? "Floor" : "Predecessor";
+    }
+
+    // 이진 트리(노드마다 key[0] 하나, children[0]/children[1]이 왼쪽/오른쪽)용 bound.
+    // 조건을 만족하는 노드를 만날 때마다 후보로 잡고, 더 가까운 키가 있을 쪽으로 내려간다.
+    // 지나는 노드를 노랗게 칠했다가 restore(node)로 원래 색을 돌려놓는다. 정의는 binary_bound.hpp에 있다.
+    template <typename N, typename Restore>
+    std::optional<T> binaryBound(T x, bool greater, bool inclusive, Restore restore);
 };
 
 template <typename T>
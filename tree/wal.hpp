@@ -0,0 +1,191 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// 트리 변경을 기록하는 write-ahead log.
+//   [헤더 "TVIZWAL1" | uint32 version | uint32 key_size][레코드 ...]
+//   레코드: uint8 op | T key | uint32 checksum (op와 key의 FNV-1a)
+// append()는 레코드를 바로 파일에 쓰므로(pwrite) 프로세스가 죽어도 남는다.
+// fdatasync는 group commit으로 모아서 한다: 레코드가 group_records개 쌓였거나 append 시점에
+// 첫 미동기 레코드로부터 max_delay_ms가 지났으면 한 번 동기화한다. 전원이 나가면 마지막 그룹만 잃을 수 있다.
+// 파일 I/O가 실패하면 runtime_error를 던진다.
+template <typename T>
+class WriteAheadLog {
+    static_assert(is_trivially_copyable<T>::value, "logged keys must be trivially copyable");
+
+public:
+    enum Op : uint8_t { INSERT = 1, REMOVE = 2 };
+
+    static const size_t RECORD_SIZE = 1 + sizeof(T) + sizeof(uint32_t);
+
+    explicit WriteAheadLog(const string& path) : path(path) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) throw runtime_error("WriteAheadLog: cannot open " + path);
+
+        struct stat st;
+        fstat(fd, &st);
+        if (st.st_size == 0) {
+            writeHeader();
+        } else {
+            char header[HEADER_SIZE];
+            if (pread(fd, header, HEADER_SIZE, 0) != (ssize_t)HEADER_SIZE || memcmp(header, "TVIZWAL1", 8) != 0
+                || get32(header + 8) != VERSION || get32(header + 12) != sizeof(T)) {
+                ::close(fd);
+                throw runtime_error("WriteAheadLog: " + path + " is not a log for this key type");
+            }
+        }
+    }
+
+    ~WriteAheadLog() {
+        try {
+            sync();
+        } catch (...) {
+        }
+        ::close(fd);
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // 레코드마다 f(op, key)를 부른다. 잘린 꼬리(마지막 write 도중 죽은 경우)는
+    // checksum으로 걸러 잘라 내고, 이후 append는 그 자리부터 쓴다. 적용한 레코드 수를 반환.
+    template <typename F>
+    uint64_t replay(F f) {
+        uint64_t count = 0;
+        off_t at = HEADER_SIZE;
+        vector<char> chunk(RECORD_SIZE * 4096);
+        while (true) {
+            ssize_t n = pread(fd, chunk.data(), chunk.size(), at);
+            if (n < 0) throw runtime_error("WriteAheadLog: pread failed on " + path);
+            size_t used = 0;
+            while (used + RECORD_SIZE <= (size_t)n) {
+                const char* r = chunk.data() + used;
+                uint8_t op = r[0];
+                if ((op != INSERT && op != REMOVE) || get32(r + 1 + sizeof(T)) != checksum(r)) {
+                    n = 0;  // 깨진 레코드부터는 버린다
+                    break;
+                }
+                T key;
+                memcpy(&key, r + 1, sizeof(T));
+                f(Op(op), key);
+                used += RECORD_SIZE;
+                count++;
+            }
+            at += used;
+            if ((size_t)n < chunk.size() || used == 0) break;
+        }
+
+        if (ftruncate(fd, at) != 0) throw runtime_error("WriteAheadLog: ftruncate failed on " + path);
+        end = at;
+        lsn = count;
+        ready = true;
+        return count;
+    }
+
+    // 레코드를 쓰고 log sequence number(1부터)를 반환한다.
+    uint64_t append(Op op, T key) {
+        if (!ready) replay([](Op, T) {});
+
+        char r[RECORD_SIZE];
+        r[0] = op;
+        memcpy(r + 1, &key, sizeof(T));
+        uint32_t sum = checksum(r);
+        memcpy(r + 1 + sizeof(T), &sum, sizeof(sum));
+        writeAll(r, RECORD_SIZE, end);
+        end += RECORD_SIZE;
+        lsn++;
+
+        if (unsynced++ == 0) first_unsynced = chrono::steady_clock::now();
+        if (unsynced >= group_records
+            || chrono::duration<double, milli>(chrono::steady_clock::now() - first_unsynced).count() >= max_delay_ms)
+            sync();
+        return lsn;
+    }
+
+    void sync() {
+        if (unsynced == 0) return;
+        if (fdatasync(fd) != 0) throw runtime_error("WriteAheadLog: fdatasync failed on " + path);
+        unsynced = 0;
+        sync_count++;
+    }
+
+    // 체크포인트 뒤에 호출해 레코드를 모두 버린다.
+    void reset() {
+        if (ftruncate(fd, HEADER_SIZE) != 0) throw runtime_error("WriteAheadLog: ftruncate failed on " + path);
+        if (fdatasync(fd) != 0) throw runtime_error("WriteAheadLog: fdatasync failed on " + path);
+        end = HEADER_SIZE;
+        lsn = 0;
+        unsynced = 0;
+        ready = true;
+    }
+
+    // group_records가 1이면 레코드마다 동기화한다.
+    void setGroupCommit(int records, double delay_ms) {
+        group_records = records < 1 ? 1 : records;
+        max_delay_ms = delay_ms;
+    }
+
+    uint64_t getSyncCount() const { return sync_count; }
+    uint64_t bytes() const { return end; }
+
+private:
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+
+    string path;
+    int fd = -1;
+    off_t end = HEADER_SIZE;
+    bool ready = false;
+    uint64_t lsn = 0;
+
+    int group_records = 64;
+    double max_delay_ms = 5.0;
+    int unsynced = 0;
+    chrono::steady_clock::time_point first_unsynced;
+    uint64_t sync_count = 0;
+
+    static uint32_t get32(const char* p) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint32_t checksum(const char* record) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < 1 + sizeof(T); i++) {
+            h ^= (unsigned char)record[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    void writeHeader() {
+        char header[HEADER_SIZE];
+        memcpy(header, "TVIZWAL1", 8);
+        uint32_t version = VERSION, key_size = sizeof(T);
+        memcpy(header + 8, &version, 4);
+        memcpy(header + 12, &key_size, 4);
+        writeAll(header, HEADER_SIZE, 0);
+        if (fdatasync(fd) != 0) throw runtime_error("WriteAheadLog: fdatasync failed on " + path);
+    }
+
+    void writeAll(const char* p, size_t n, off_t at) {
+        while (n > 0) {
+            ssize_t w = pwrite(fd, p, n, at);
+            if (w <= 0) throw runtime_error("WriteAheadLog: pwrite failed on " + path);
+            p += w;
+            n -= w;
+            at += w;
+        }
+    }
+};
@@ -63,9 +63,15 @@ public:
         delay = duration;
     }
 
+    // 벤치마크처럼 화면 출력 없이 트리 연산만 돌릴 때 끈다.
+    static inline void setRenderEnabled(bool enabled) {
+        render_enabled = enabled;
+    }
+
 private:
     inline static chrono::milliseconds delay{chrono::milliseconds{1000}};
     inline static DelayMode delay_mode{DelayMode::TIME};
+    inline static bool render_enabled{true};
 
     friend class Visualizer;
 };
@@ -79,6 +85,7 @@ public:
     }
 
     void render() {
+        if (!VisualizerConfig::render_enabled) return;
         screen_clear();
         cout << "[ TASK ]\n"
                 << title << "\n\n"
@@ -99,24 +106,30 @@ public:
         wait();
     }
 
+    // 출력이 꺼져 있으면 색상/메시지 상태도 쌓지 않는다.
     void setTitle(const string& t) {
+        if (!VisualizerConfig::render_enabled) return;
         title = t;
     }
 
     void setMessage(const string& m) {
+        if (!VisualizerConfig::render_enabled) return;
         message = m;
     }
 
     void setColor(Node* node, int key_idx, Color c) {
+        if (!VisualizerConfig::render_enabled) return;
         status[{node, key_idx}].color = c;
     }
 
     void setColor(Node* node, Color c) {
+        if (!VisualizerConfig::render_enabled) return;
         for (int i = 0; i < node->getKeyCount(); i++)
             status[{node, i}].color = c;
     }
 
     void clear() {
+        if (!VisualizerConfig::render_enabled) return;
         status.clear();
         message.clear();
     }
@@ -229,4 +242,8 @@ private:
     }
 };
 
+inline Tree::~Tree() {
+    delete vis;
+}
+
 